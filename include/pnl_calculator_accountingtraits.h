@@ -29,7 +29,7 @@ namespace pnl::traits
         }
     };
 
-    template <enums::AccountingType Method>
+    template <enums::AccountingType Method, enums::LotBookType Book = enums::LotBookType::DEQUE>
     struct AccountingTraits : AccountingTraitsBase
     {
         using method_type = std::integral_constant<enums::AccountingType, Method>;
@@ -37,10 +37,13 @@ namespace pnl::traits
         static constexpr enums::AccountingType accounting_method = Method;
         static constexpr bool is_fifo = (Method == enums::AccountingType::FIFO);
         static constexpr bool is_lifo = (Method == enums::AccountingType::LIFO);
+
+        static constexpr enums::LotBookType lot_book = Book;
+        static constexpr bool use_indexed_lot_book = (Book == enums::LotBookType::INDEXED);
     };
 
-    template <>
-    struct AccountingTraits<enums::AccountingType::FIFO> : AccountingTraitsBase
+    template <enums::LotBookType Book>
+    struct AccountingTraits<enums::AccountingType::FIFO, Book> : AccountingTraitsBase
     {
         using method_type = std::integral_constant<enums::AccountingType, enums::AccountingType::FIFO>;
 
@@ -48,12 +51,15 @@ namespace pnl::traits
         static constexpr bool is_fifo = true;
         static constexpr bool is_lifo = false;
 
+        static constexpr enums::LotBookType lot_book = Book;
+        static constexpr bool use_indexed_lot_book = (Book == enums::LotBookType::INDEXED);
+
         static constexpr bool use_front_access = true;
         static constexpr bool reverse_iteration = false;
     };
 
-    template <>
-    struct AccountingTraits<enums::AccountingType::LIFO> : AccountingTraitsBase
+    template <enums::LotBookType Book>
+    struct AccountingTraits<enums::AccountingType::LIFO, Book> : AccountingTraitsBase
     {
         using method_type = std::integral_constant<enums::AccountingType, enums::AccountingType::LIFO>;
 
@@ -61,6 +67,9 @@ namespace pnl::traits
         static constexpr bool is_fifo = false;
         static constexpr bool is_lifo = true;
 
+        static constexpr enums::LotBookType lot_book = Book;
+        static constexpr bool use_indexed_lot_book = (Book == enums::LotBookType::INDEXED);
+
         static constexpr bool use_front_access = false;
         static constexpr bool reverse_iteration = true;
     };
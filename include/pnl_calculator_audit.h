@@ -0,0 +1,78 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace pnl::audit
+{
+    // One opening lot (fully or partly) consumed by a closing trade. symbol is only valid for
+    // the duration of the record() call.
+    struct LotMatch
+    {
+        types::sequence_t sequence;
+        types::timestamp_t timestamp;
+        std::string_view symbol;
+        enums::TradeSide side;
+        types::price_t trade_price;
+        types::timestamp_t lot_timestamp;
+        types::price_t lot_price;
+        types::quantity_t quantity;
+        types::pnl_t pnl;
+    };
+
+    // Default sink: enabled is false, so every record site is discarded by if constexpr and the
+    // sink occupies no storage in the tracker.
+    struct NullAuditSink
+    {
+        static constexpr bool enabled = false;
+
+        void record(const LotMatch&) const noexcept {}
+    };
+
+    // Appends LotMatch rows as CSV (AUDIT_CSV_HEADER) to an in-memory buffer and writes it out
+    // with write(2) whenever AUDIT_BUFFER_SIZE is reached. Numbers are formatted with
+    // std::to_chars, so the matching loop never touches iostreams. Throws std::system_error on
+    // I/O failure; the destructor flushes what is left.
+    class LotMatchCsvWriter
+    {
+    private:
+        int fd_ = -1;
+        std::string buffer_;
+        std::uint64_t records_ = 0;
+
+        template <typename Number>
+        void append_number(Number value);
+        void append_field(std::string_view field);
+
+    public:
+        LotMatchCsvWriter(const LotMatchCsvWriter&) = delete;
+        LotMatchCsvWriter& operator=(const LotMatchCsvWriter&) = delete;
+        LotMatchCsvWriter(LotMatchCsvWriter&&) = delete;
+        LotMatchCsvWriter& operator=(LotMatchCsvWriter&&) = delete;
+
+        explicit LotMatchCsvWriter(const std::string& filename);
+        ~LotMatchCsvWriter();
+
+        void append(const LotMatch& match);
+        void flush();
+
+        [[nodiscard]] std::uint64_t records() const noexcept { return records_; }
+    };
+
+    // Enabled sink forwarding to a caller-owned writer; trivially copyable into the engine.
+    struct CsvAuditSink
+    {
+        static constexpr bool enabled = true;
+
+        LotMatchCsvWriter* writer;
+
+        void record(const LotMatch& match) const { writer->append(match); }
+    };
+}
+
+#include "pnl_calculator_audit.hxx"
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace pnl::audit
+{
+    inline LotMatchCsvWriter::LotMatchCsvWriter(const std::string& filename)
+    {
+        fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not create " + filename);
+        }
+
+        buffer_.reserve(constants::AUDIT_BUFFER_SIZE + 256);
+        buffer_.append(constants::AUDIT_CSV_HEADER);
+        buffer_.push_back('\n');
+    }
+
+    inline LotMatchCsvWriter::~LotMatchCsvWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    template <typename Number>
+    inline void LotMatchCsvWriter::append_number(Number value)
+    {
+        std::array<char, 32> digits;
+        const auto [end, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        buffer_.append(digits.data(), static_cast<std::size_t>(end - digits.data()));
+        buffer_.push_back(constants::CSV_DELIMITER);
+    }
+
+    inline void LotMatchCsvWriter::append_field(std::string_view field)
+    {
+        buffer_.append(field);
+        buffer_.push_back(constants::CSV_DELIMITER);
+    }
+
+    inline void LotMatchCsvWriter::append(const LotMatch& match)
+    {
+        append_number(match.sequence);
+        append_number(match.timestamp);
+        append_field(match.symbol);
+        buffer_.push_back(match.side == enums::TradeSide::BUY ? constants::BUY_INDICATOR : constants::SELL_INDICATOR);
+        buffer_.push_back(constants::CSV_DELIMITER);
+        append_number(match.trade_price);
+        append_number(match.lot_timestamp);
+        append_number(match.lot_price);
+        append_number(match.quantity);
+        append_number(match.pnl);
+        buffer_.back() = '\n';
+        ++records_;
+
+        if (buffer_.size() >= constants::AUDIT_BUFFER_SIZE) [[unlikely]]
+        {
+            flush();
+        }
+    }
+
+    inline void LotMatchCsvWriter::flush()
+    {
+        const char* data = buffer_.data();
+        std::size_t remaining = buffer_.size();
+        while (remaining > 0)
+        {
+            const ssize_t written = ::write(fd_, data, remaining);
+            if (written < 0) [[unlikely]]
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Could not write audit file");
+            }
+            data += written;
+            remaining -= static_cast<std::size_t>(written);
+        }
+        buffer_.clear();
+    }
+}
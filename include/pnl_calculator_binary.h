@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+namespace pnl::io
+{
+    // On-disk layout: header, record_count fixed-width records, then the symbol dictionary
+    // trailer at dictionary_offset (per symbol: uint16 length followed by the bytes).
+    struct BinaryResultHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t record_size;
+        std::uint64_t record_count;
+        std::uint64_t dictionary_offset;
+        std::uint32_t symbol_count;
+        std::uint32_t reserved;
+    };
+
+    struct BinaryResultRecord
+    {
+        std::uint64_t timestamp;
+        std::int64_t pnl_cents;
+        std::uint32_t symbol_id;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(BinaryResultHeader) == 40);
+    static_assert(sizeof(BinaryResultRecord) == 24);
+
+    // Writes results into a pre-sized shared file mapping; each append is a single memcpy.
+    // The mapping grows geometrically if the initial estimate is exceeded and the file is
+    // truncated to its exact size by finish(). Throws std::system_error on I/O failure and on
+    // symbols longer than the dictionary's 16-bit length field.
+    class BinaryResultWriter
+    {
+    private:
+        int fd_ = -1;
+        std::byte* data_ = nullptr;
+        std::size_t mapped_size_ = 0;
+        std::size_t write_offset_ = sizeof(BinaryResultHeader);
+        std::uint64_t record_count_ = 0;
+        std::unordered_map<std::string, std::uint32_t> symbol_ids_;
+        std::vector<std::string> symbols_;
+        bool finished_ = false;
+
+        void ensure_capacity(std::size_t additional_bytes);
+        void remap(std::size_t new_size);
+        [[nodiscard]] std::uint32_t intern_symbol(const types::symbol_t& symbol);
+
+    public:
+        BinaryResultWriter(const BinaryResultWriter&) = delete;
+        BinaryResultWriter& operator=(const BinaryResultWriter&) = delete;
+        BinaryResultWriter(BinaryResultWriter&&) = delete;
+        BinaryResultWriter& operator=(BinaryResultWriter&&) = delete;
+        ~BinaryResultWriter();
+
+        explicit BinaryResultWriter(const std::string& filename,
+                                    std::size_t expected_records = constants::DEFAULT_RESERVE_SIZE);
+
+        void append(const types::PnLResult& result);
+        void finish();
+
+        [[nodiscard]] std::uint64_t record_count() const noexcept { return record_count_; }
+    };
+
+    // Read-only mapping of a file produced by BinaryResultWriter.
+    class BinaryResultReader
+    {
+    private:
+        const std::byte* data_ = nullptr;
+        std::size_t mapped_size_ = 0;
+        const BinaryResultHeader* header_ = nullptr;
+        std::vector<std::string_view> symbols_;
+
+        bool load_dictionary() noexcept;
+
+    public:
+        BinaryResultReader(const BinaryResultReader&) = delete;
+        BinaryResultReader& operator=(const BinaryResultReader&) = delete;
+        BinaryResultReader(BinaryResultReader&&) = delete;
+        BinaryResultReader& operator=(BinaryResultReader&&) = delete;
+        ~BinaryResultReader();
+
+        explicit BinaryResultReader(const std::string& filename);
+
+        [[nodiscard]] bool is_valid() const noexcept { return header_ != nullptr; }
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] BinaryResultRecord record(std::size_t index) const noexcept;
+        [[nodiscard]] std::string_view symbol(std::uint32_t symbol_id) const noexcept;
+        [[nodiscard]] types::PnLResult result(std::size_t index) const;
+    };
+
+    [[nodiscard]] std::int64_t pnl_to_cents(types::pnl_t pnl) noexcept;
+    [[nodiscard]] types::pnl_t cents_to_pnl(std::int64_t cents) noexcept;
+
+    // Re-emits a binary results file in the CSV format written by the CLI.
+    [[nodiscard]] bool convert_binary_to_csv(const std::string& filename, std::ostream& out);
+}
+
+#include "pnl_calculator_binary.hxx"
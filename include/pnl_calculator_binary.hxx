@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pnl::io
+{
+    inline constexpr char BINARY_RESULT_MAGIC[8] = {'P', 'N', 'L', 'R', 'E', 'S', '\0', '\0'};
+    inline constexpr std::uint32_t BINARY_RESULT_VERSION = 1;
+
+    inline std::int64_t pnl_to_cents(types::pnl_t pnl) noexcept
+    {
+        return std::llround(static_cast<double>(pnl) * traits::AccountingTraitsBase::precision_multiplier);
+    }
+
+    inline types::pnl_t cents_to_pnl(std::int64_t cents) noexcept
+    {
+        return static_cast<types::pnl_t>(cents) / traits::AccountingTraitsBase::precision_multiplier;
+    }
+
+    inline BinaryResultWriter::BinaryResultWriter(const std::string& filename, std::size_t expected_records)
+    {
+        fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not create " + filename);
+        }
+
+        try
+        {
+            remap(sizeof(BinaryResultHeader) + std::max<std::size_t>(expected_records, 1) * sizeof(BinaryResultRecord));
+        }
+        catch (...)
+        {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    inline BinaryResultWriter::~BinaryResultWriter()
+    {
+        try
+        {
+            finish();
+        }
+        catch (...)
+        {
+        }
+
+        if (data_ != nullptr)
+        {
+            ::munmap(data_, mapped_size_);
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    inline void BinaryResultWriter::remap(std::size_t new_size)
+    {
+        if (::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not size binary result file");
+        }
+
+        void* mapping = (data_ == nullptr)
+                      ? ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+                      : ::mremap(data_, mapped_size_, new_size, MREMAP_MAYMOVE);
+        if (mapping == MAP_FAILED) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not map binary result file");
+        }
+
+        data_ = static_cast<std::byte*>(mapping);
+        mapped_size_ = new_size;
+    }
+
+    inline void BinaryResultWriter::ensure_capacity(std::size_t additional_bytes)
+    {
+        if (write_offset_ + additional_bytes > mapped_size_) [[unlikely]]
+        {
+            remap(std::max(mapped_size_ * 2, write_offset_ + additional_bytes));
+        }
+    }
+
+    inline std::uint32_t BinaryResultWriter::intern_symbol(const types::symbol_t& symbol)
+    {
+        const auto it = symbol_ids_.find(symbol);
+        if (it != symbol_ids_.end()) [[likely]]
+        {
+            return it->second;
+        }
+
+        // The dictionary stores lengths as uint16_t; refuse rather than write a different symbol.
+        if (symbol.size() > std::numeric_limits<std::uint16_t>::max()) [[unlikely]]
+        {
+            throw std::system_error(std::make_error_code(std::errc::value_too_large),
+                                    "Symbol of " + std::to_string(symbol.size()) + " bytes is too long for binary output");
+        }
+
+        const auto id = static_cast<std::uint32_t>(symbols_.size());
+        symbol_ids_.emplace(symbol, id);
+        symbols_.push_back(symbol);
+        return id;
+    }
+
+    inline void BinaryResultWriter::append(const types::PnLResult& result)
+    {
+        const BinaryResultRecord record{
+            result.timestamp(),
+            pnl_to_cents(result.pnl()),
+            intern_symbol(result.symbol()),
+            0
+        };
+
+        ensure_capacity(sizeof(record));
+        std::memcpy(data_ + write_offset_, &record, sizeof(record));
+        write_offset_ += sizeof(record);
+        ++record_count_;
+    }
+
+    inline void BinaryResultWriter::finish()
+    {
+        if (finished_ || data_ == nullptr)
+        {
+            return;
+        }
+        finished_ = true;
+
+        const std::uint64_t dictionary_offset = write_offset_;
+        for (const auto& symbol : symbols_)
+        {
+            const auto length = static_cast<std::uint16_t>(symbol.size());
+            ensure_capacity(sizeof(length) + length);
+            std::memcpy(data_ + write_offset_, &length, sizeof(length));
+            std::memcpy(data_ + write_offset_ + sizeof(length), symbol.data(), length);
+            write_offset_ += sizeof(length) + length;
+        }
+
+        BinaryResultHeader header{};
+        std::memcpy(header.magic, BINARY_RESULT_MAGIC, sizeof(header.magic));
+        header.version = BINARY_RESULT_VERSION;
+        header.record_size = sizeof(BinaryResultRecord);
+        header.record_count = record_count_;
+        header.dictionary_offset = dictionary_offset;
+        header.symbol_count = static_cast<std::uint32_t>(symbols_.size());
+        std::memcpy(data_, &header, sizeof(header));
+
+        ::munmap(data_, mapped_size_);
+        data_ = nullptr;
+
+        if (::ftruncate(fd_, static_cast<off_t>(write_offset_)) != 0) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not truncate binary result file");
+        }
+    }
+
+    inline BinaryResultReader::BinaryResultReader(const std::string& filename)
+    {
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) [[unlikely]]
+        {
+            return;
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(BinaryResultHeader))
+        {
+            void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) [[likely]]
+            {
+                data_ = static_cast<const std::byte*>(mapping);
+                mapped_size_ = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+
+        if (data_ == nullptr) [[unlikely]]
+        {
+            return;
+        }
+
+        const auto* header = reinterpret_cast<const BinaryResultHeader*>(data_);
+        const bool valid_header = std::memcmp(header->magic, BINARY_RESULT_MAGIC, sizeof(header->magic)) == 0
+                                && header->version == BINARY_RESULT_VERSION
+                                && header->record_size == sizeof(BinaryResultRecord)
+                                && header->dictionary_offset >= sizeof(BinaryResultHeader)
+                                && header->dictionary_offset <= mapped_size_
+                                && (header->dictionary_offset - sizeof(BinaryResultHeader)) % sizeof(BinaryResultRecord) == 0
+                                && header->record_count
+                                   == (header->dictionary_offset - sizeof(BinaryResultHeader)) / sizeof(BinaryResultRecord);
+        if (valid_header) [[likely]]
+        {
+            header_ = header;
+            if (!load_dictionary()) [[unlikely]]
+            {
+                header_ = nullptr;
+            }
+        }
+    }
+
+    inline BinaryResultReader::~BinaryResultReader()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), mapped_size_);
+        }
+    }
+
+    inline bool BinaryResultReader::load_dictionary() noexcept
+    {
+        std::size_t offset = header_->dictionary_offset;
+        symbols_.reserve(header_->symbol_count);
+
+        for (std::uint32_t i = 0; i < header_->symbol_count; ++i)
+        {
+            std::uint16_t length = 0;
+            if (offset + sizeof(length) > mapped_size_) [[unlikely]]
+            {
+                return false;
+            }
+            std::memcpy(&length, data_ + offset, sizeof(length));
+            offset += sizeof(length);
+
+            if (offset + length > mapped_size_) [[unlikely]]
+            {
+                return false;
+            }
+            symbols_.emplace_back(reinterpret_cast<const char*>(data_ + offset), length);
+            offset += length;
+        }
+
+        return true;
+    }
+
+    inline std::size_t BinaryResultReader::size() const noexcept
+    {
+        return is_valid() ? static_cast<std::size_t>(header_->record_count) : 0;
+    }
+
+    inline BinaryResultRecord BinaryResultReader::record(std::size_t index) const noexcept
+    {
+        assert(index < size());
+        BinaryResultRecord record;
+        std::memcpy(&record, data_ + sizeof(BinaryResultHeader) + index * sizeof(BinaryResultRecord), sizeof(record));
+        return record;
+    }
+
+    inline std::string_view BinaryResultReader::symbol(std::uint32_t symbol_id) const noexcept
+    {
+        return symbol_id < symbols_.size() ? symbols_[symbol_id] : std::string_view{};
+    }
+
+    inline types::PnLResult BinaryResultReader::result(std::size_t index) const
+    {
+        const auto rec = record(index);
+        return types::PnLResult{rec.timestamp, types::symbol_t(symbol(rec.symbol_id)), cents_to_pnl(rec.pnl_cents)};
+    }
+
+    inline bool convert_binary_to_csv(const std::string& filename, std::ostream& out)
+    {
+        BinaryResultReader reader(filename);
+        if (!reader.is_valid()) [[unlikely]]
+        {
+            return false;
+        }
+
+        out << constants::CSV_HEADER << '\n';
+        for (std::size_t i = 0; i < reader.size(); ++i)
+        {
+            out << reader.result(i).to_csv_string() << '\n';
+        }
+        out.flush();
+
+        return static_cast<bool>(out);
+    }
+}
@@ -26,6 +26,13 @@ namespace pnl::concepts
         { T::decimal_precision } -> std::convertible_to<int>;
     };
 
+    template <typename T, typename Record>
+    concept AuditSink = requires(T sink, const Record& record)
+    {
+        { T::enabled } -> std::convertible_to<bool>;
+        sink.record(record);
+    };
+
     template <typename T>
     concept Trade = requires(T t)
     {
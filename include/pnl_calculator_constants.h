@@ -11,14 +11,49 @@ namespace pnl::constants
     constexpr std::size_t DEFAULT_RESERVE_SIZE = 1024;
     constexpr std::size_t CACHE_LINE_SIZE = 64;
     constexpr std::size_t MAX_SYMBOL_LENGTH = 16;
+    constexpr std::size_t DEFAULT_REORDER_CAPACITY = 65536;
+    constexpr std::size_t MIN_LOT_BOOK_CAPACITY = 16;
+    constexpr double PRICE_TICKS_PER_UNIT = 1e6;
+    constexpr std::size_t IO_CHUNK_SIZE = 1 << 20;
+    constexpr std::size_t IO_QUEUE_DEPTH = 4;
+    constexpr std::size_t IO_BUFFER_ALIGNMENT = 4096;
+    constexpr std::size_t SPILL_COMPACTION_MIN_BYTES = 1 << 26;
+    constexpr std::size_t AUDIT_BUFFER_SIZE = 1 << 20;
+    constexpr std::size_t DEFAULT_SNAPSHOT_CAPACITY = 4096;
+    constexpr unsigned SNAPSHOT_MAX_BACKOFF_SPINS = 64;
+    constexpr unsigned SEQUENCE_SOURCE_SHIFT = 40;
 
     constexpr char CSV_DELIMITER = ',';
     constexpr char BUY_INDICATOR = 'B';
     constexpr char SELL_INDICATOR = 'S';
 
     constexpr const char* CSV_HEADER = "timestamp,symbol,pnl";
+    constexpr const char* SEQUENCED_CSV_HEADER = "sequence,timestamp,symbol,pnl";
+    constexpr const char* AUDIT_CSV_HEADER =
+        "sequence,timestamp,symbol,side,trade_price,lot_timestamp,lot_price,quantity,pnl";
     constexpr const char* FIFO_ARG = "fifo";
     constexpr const char* LIFO_ARG = "lifo";
+    constexpr const char* REORDER_WINDOW_OPT = "--reorder-window=";
+    constexpr const char* LOT_BOOK_OPT = "--lot-book=";
+    constexpr const char* DEQUE_LOT_BOOK_ARG = "deque";
+    constexpr const char* INDEXED_LOT_BOOK_ARG = "indexed";
+    constexpr const char* BINARY_OUTPUT_OPT = "--binary-output=";
+    constexpr const char* TO_CSV_MODE = "to-csv";
+    constexpr const char* PERF_COUNTERS_OPT = "--perf-counters";
+    constexpr const char* IO_BACKEND_OPT = "--io-backend=";
+    constexpr const char* READ_IO_BACKEND_ARG = "read";
+    constexpr const char* URING_IO_BACKEND_ARG = "uring";
+    constexpr const char* SYMBOLS_OPT = "--symbols=";
+    constexpr const char* FROM_OPT = "--from=";
+    constexpr const char* TO_OPT = "--to=";
+    constexpr const char* MEMORY_BUDGET_OPT = "--memory-budget=";
+    constexpr const char* SPILL_DIR_OPT = "--spill-dir=";
+    constexpr const char* SPILL_FILE_PREFIX = "pnl_calculator_lots.spill";
+    constexpr const char* SHARD_MODE = "shard";
+    constexpr const char* MERGE_MODE = "merge";
+    constexpr const char* SEQUENCED_OPT = "--sequenced";
+    constexpr const char* AUDIT_OPT = "--audit=";
+    constexpr const char* SHARD_FILE_EXTENSION = ".csv";
 
     constexpr int SUCCESS = 0;
     constexpr int ERROR_INVALID_ARGS = 1;
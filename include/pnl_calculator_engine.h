@@ -4,32 +4,75 @@
 #include "pnl_calculator_types.h"
 #include "pnl_calculator_accountingtraits.h"
 #include "pnl_calculator_macros.h"
+#include "pnl_calculator_lotbook.h"
+#include "pnl_calculator_spill.h"
+#include "pnl_calculator_audit.h"
+#include "pnl_calculator_snapshot.h"
 #include <unordered_map>
 #include <deque>
+#include <list>
+#include <memory>
+#include <string>
 #include <vector>
 #include <ranges>
 #include <algorithm>
+#include <type_traits>
 
 namespace pnl::engine
 {
     template <typename T>
     using PositionContainer = std::deque<T>;
 
-    template <concepts::AccountingMethod AccountingTraits>
+    template <typename AccountingTraits>
+    using LotBook = std::conditional_t<AccountingTraits::use_indexed_lot_book,
+                                       IndexedLotBook,
+                                       PositionContainer<types::Position>>;
+
+    // AuditSink receives one audit::LotMatch per consumed lot. With the default NullAuditSink the
+    // record sites compile away and the sink takes no space.
+    template <concepts::AccountingMethod AccountingTraits,
+              concepts::AuditSink<audit::LotMatch> AuditSink = audit::NullAuditSink>
     class CACHE_LINE_ALIGNED PositionTracker
     {
     private:
         using traits_type = AccountingTraits;
-        using position_container = PositionContainer<types::Position>;
+        using position_container = LotBook<AccountingTraits>;
+
+        // Least-recently-traded eviction state, present only when a lot budget is set.
+        struct SpillState
+        {
+            struct Residency
+            {
+                std::list<std::string>::iterator recency_position;
+                std::size_t lots = 0;
+            };
+
+            std::size_t lot_budget;
+            LotSpillStore store;
+            std::list<std::string> recency;
+            std::unordered_map<std::string, Residency> residency;
+            std::size_t resident_lots = 0;
+            std::size_t peak_resident_lots = 0;
+
+            SpillState(std::size_t budget, std::string directory) : lot_budget(budget), store(std::move(directory)) {}
+        };
 
         std::unordered_map<std::string, position_container> buy_positions_;
         std::unordered_map<std::string, position_container> sell_positions_;
+        std::unique_ptr<SpillState> spill_;
+        std::unique_ptr<SnapshotTable> snapshots_;
+        [[no_unique_address]] AuditSink audit_;
 
         FORCE_INLINE double calculate_pnl(
             const types::Position& position,
             const types::Trade& trade,
             typename AccountingTraits::quantity_t quantity) const noexcept;
 
+        FORCE_INLINE void record_match(
+            const types::Position& position,
+            const types::Trade& trade,
+            typename AccountingTraits::quantity_t quantity);
+
         double clear_positions_fifo(
             position_container& positions,
             const types::Trade& trade,
@@ -40,10 +83,27 @@ namespace pnl::engine
             const types::Trade& trade,
             typename AccountingTraits::quantity_t& remaining_quantity);
 
+        // Quantity closed against opposite lots and the realized PnL reported for it.
+        struct MatchOutcome
+        {
+            typename AccountingTraits::quantity_t closed_quantity;
+            double realized_pnl;
+        };
+
+        template <typename PnLCallback>
+        MatchOutcome match_trade(const types::Trade& trade, PnLCallback&& callback);
+
+        [[nodiscard]] std::size_t lot_count(const std::string& symbol) const noexcept;
+        [[nodiscard]] static std::uint64_t open_quantity(const position_container& positions) noexcept;
+        typename SpillState::Residency& page_in(const std::string& symbol);
+        void settle_residency(const std::string& symbol, typename SpillState::Residency& residency);
+        void spill_coldest();
+
     public:
         RULE_OF_FIVE_MOVABLE(PositionTracker)
 
         PositionTracker();
+        explicit PositionTracker(AuditSink audit);
 
         void add_position(
             const std::string& symbol,
@@ -53,14 +113,34 @@ namespace pnl::engine
         template <typename PnLCallback>
         requires std::invocable<PnLCallback, types::PnLResult>
         void process_trade(const types::Trade& trade, PnLCallback&& callback);
+
+        // Caps resident open lots at lot_budget by spilling the books of the least recently
+        // traded symbols to an anonymous file in directory; a spilled symbol is paged back in on
+        // its next trade. The symbol being traded is never evicted, so one oversized book may
+        // exceed the budget. Calling it again pages every spilled book back in before switching
+        // to the new budget and directory.
+        void enable_spilling(std::size_t lot_budget, std::string directory);
+        [[nodiscard]] bool spilling_enabled() const noexcept { return spill_ != nullptr; }
+        [[nodiscard]] LotSpillStats spill_stats() const;
+
+        // Publishes per-symbol open quantity, realized PnL and last timestamp to a seqlocked
+        // table that other threads may read while trades are processed. Open quantity is seeded
+        // from the lots already held (resident or spilled); realized PnL and trade counts cover
+        // trades from this call on. At most max_symbols symbols are tracked. The table lives as
+        // long as the tracker; calling this again returns the same table and ignores max_symbols.
+        const SnapshotTable& enable_snapshots(std::size_t max_symbols = constants::DEFAULT_SNAPSHOT_CAPACITY);
+        [[nodiscard]] const SnapshotTable* snapshots() const noexcept { return snapshots_.get(); }
+
+        void clear();
     };
 
-    template <concepts::AccountingMethod AccountingTraits>
+    template <concepts::AccountingMethod AccountingTraits,
+              concepts::AuditSink<audit::LotMatch> AuditSink = audit::NullAuditSink>
     class PnLCalculationEngine
     {
     private:
         using traits_type = AccountingTraits;
-        using position_tracker_type = PositionTracker<AccountingTraits>;
+        using position_tracker_type = PositionTracker<AccountingTraits, AuditSink>;
 
         position_tracker_type position_tracker_;
         std::vector<types::PnLResult> results_;
@@ -69,6 +149,9 @@ namespace pnl::engine
         RULE_OF_FIVE_MOVABLE(PnLCalculationEngine)
 
         PnLCalculationEngine();
+        explicit PnLCalculationEngine(AuditSink audit);
+
+        void process_trade(const types::Trade& trade);
 
         template <concepts::TradeContainer Container>
         void process_trades(const Container& trades);
@@ -80,13 +163,22 @@ namespace pnl::engine
         [[nodiscard]] const std::vector<types::PnLResult>& get_results() const noexcept;
         [[nodiscard]] std::vector<types::PnLResult> extract_results() noexcept;
 
-        void clear() noexcept;
+        void enable_spilling(std::size_t lot_budget, std::string directory);
+        [[nodiscard]] LotSpillStats spill_stats() const;
+
+        const SnapshotTable& enable_snapshots(std::size_t max_symbols = constants::DEFAULT_SNAPSHOT_CAPACITY);
+        [[nodiscard]] const SnapshotTable* snapshots() const noexcept;
+
+        void clear();
         [[nodiscard]] std::size_t size() const noexcept;
         [[nodiscard]] bool empty() const noexcept;
     };
 
-    template <enums::AccountingType Method>
+    template <enums::AccountingType Method, enums::LotBookType Book = enums::LotBookType::DEQUE>
     auto create_engine();
+
+    template <enums::AccountingType Method, enums::LotBookType Book, concepts::AuditSink<audit::LotMatch> AuditSink>
+    auto create_engine(AuditSink audit);
 }
 
 #include "pnl_calculator_engine.hxx"
\ No newline at end of file
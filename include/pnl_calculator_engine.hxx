@@ -1,18 +1,27 @@
 #pragma once
 
 #include <cmath>
+#include <type_traits>
+#include <utility>
 
 namespace pnl::engine
 {
-    template <concepts::AccountingMethod AccountingTraits>
-    inline PositionTracker<AccountingTraits>::PositionTracker()
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline PositionTracker<AccountingTraits, AuditSink>::PositionTracker()
     {
         buy_positions_.reserve(AccountingTraits::default_reserve_size);
         sell_positions_.reserve(AccountingTraits::default_reserve_size);
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline void PositionTracker<AccountingTraits>::add_position(
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline PositionTracker<AccountingTraits, AuditSink>::PositionTracker(AuditSink audit)
+        : PositionTracker()
+    {
+        audit_ = std::move(audit);
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::add_position(
         const std::string& symbol,
         const types::Position& position,
         enums::TradeSide side)
@@ -21,8 +30,8 @@ namespace pnl::engine
         container.emplace_back(position);
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline double PositionTracker<AccountingTraits>::calculate_pnl(
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline double PositionTracker<AccountingTraits, AuditSink>::calculate_pnl(
         const types::Position& position,
         const types::Trade& trade,
         typename AccountingTraits::quantity_t quantity) const noexcept
@@ -32,8 +41,26 @@ namespace pnl::engine
                : static_cast<double>(quantity) * (static_cast<double>(trade.price()) - static_cast<double>(position.price()));
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline double PositionTracker<AccountingTraits>::clear_positions_fifo(
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::record_match(
+        const types::Position& position,
+        const types::Trade& trade,
+        typename AccountingTraits::quantity_t quantity)
+    {
+        audit_.record(audit::LotMatch{
+            trade.sequence(),
+            trade.timestamp(),
+            trade.symbol(),
+            trade.side(),
+            trade.price(),
+            position.timestamp(),
+            position.price(),
+            quantity,
+            AccountingTraits::format_precision(calculate_pnl(position, trade, quantity))});
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline double PositionTracker<AccountingTraits, AuditSink>::clear_positions_fifo(
         position_container& positions,
         const types::Trade& trade,
         typename AccountingTraits::quantity_t& remaining_quantity)
@@ -46,6 +73,10 @@ namespace pnl::engine
             const typename AccountingTraits::quantity_t clear_quantity = std::min(remaining_quantity, position.quantity());
 
             total_pnl += calculate_pnl(position, trade, clear_quantity);
+            if constexpr (AuditSink::enabled)
+            {
+                record_match(position, trade, clear_quantity);
+            }
             remaining_quantity -= clear_quantity;
             position.reduce_quantity(clear_quantity);
 
@@ -58,8 +89,8 @@ namespace pnl::engine
         return total_pnl;
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline double PositionTracker<AccountingTraits>::clear_positions_lifo(
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline double PositionTracker<AccountingTraits, AuditSink>::clear_positions_lifo(
         position_container& positions,
         const types::Trade& trade,
         typename AccountingTraits::quantity_t& remaining_quantity)
@@ -72,6 +103,10 @@ namespace pnl::engine
             const typename AccountingTraits::quantity_t clear_quantity = std::min(remaining_quantity, position.quantity());
 
             total_pnl += calculate_pnl(position, trade, clear_quantity);
+            if constexpr (AuditSink::enabled)
+            {
+                record_match(position, trade, clear_quantity);
+            }
             remaining_quantity -= clear_quantity;
             position.reduce_quantity(clear_quantity);
 
@@ -84,10 +119,41 @@ namespace pnl::engine
         return total_pnl;
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
     template <typename PnLCallback>
     requires std::invocable<PnLCallback, types::PnLResult>
-    inline void PositionTracker<AccountingTraits>::process_trade(
+    inline void PositionTracker<AccountingTraits, AuditSink>::process_trade(
+        const types::Trade& trade,
+        PnLCallback&& callback)
+    {
+        if (spill_ == nullptr && snapshots_ == nullptr) LIKELY
+        {
+            match_trade(trade, std::forward<PnLCallback>(callback));
+            return;
+        }
+
+        auto* residency = (spill_ != nullptr) ? &page_in(trade.symbol()) : nullptr;
+        const auto outcome = match_trade(trade, std::forward<PnLCallback>(callback));
+
+        if (snapshots_ != nullptr)
+        {
+            snapshots_->apply(trade.symbol(),
+                              trade.side(),
+                              trade.quantity() - outcome.closed_quantity,
+                              outcome.closed_quantity,
+                              outcome.realized_pnl,
+                              trade.timestamp());
+        }
+        if (residency != nullptr)
+        {
+            settle_residency(trade.symbol(), *residency);
+        }
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    template <typename PnLCallback>
+    inline typename PositionTracker<AccountingTraits, AuditSink>::MatchOutcome
+    PositionTracker<AccountingTraits, AuditSink>::match_trade(
         const types::Trade& trade,
         PnLCallback&& callback)
     {
@@ -101,13 +167,34 @@ namespace pnl::engine
         if (opposite_positions.empty()) LIKELY
         {
             add_position(symbol, types::Position{trade.price(), trade.quantity(), trade.timestamp()}, trade.side());
-            return;
+            return MatchOutcome{0, 0.0};
         }
 
         typename AccountingTraits::quantity_t remaining_quantity = trade.quantity();
         double total_pnl = 0.0;
 
-        if constexpr (AccountingTraits::is_fifo)
+        if constexpr (AccountingTraits::use_indexed_lot_book)
+        {
+            if constexpr (AuditSink::enabled)
+            {
+                const auto record = [this, &trade](const types::Position& position, types::quantity_t quantity)
+                {
+                    record_match(position, trade, quantity);
+                };
+                if constexpr (AccountingTraits::is_fifo)
+                {
+                    opposite_positions.visit_front(remaining_quantity, record);
+                }
+                else
+                {
+                    opposite_positions.visit_back(remaining_quantity, record);
+                }
+            }
+            total_pnl = AccountingTraits::is_fifo
+                      ? opposite_positions.clear_front(trade, remaining_quantity)
+                      : opposite_positions.clear_back(trade, remaining_quantity);
+        }
+        else if constexpr (AccountingTraits::is_fifo)
         {
             total_pnl = clear_positions_fifo(opposite_positions, trade, remaining_quantity);
         }
@@ -121,21 +208,236 @@ namespace pnl::engine
             add_position(symbol, types::Position{trade.price(), remaining_quantity, trade.timestamp()}, trade.side());
         }
 
+        const auto closed_quantity = static_cast<typename AccountingTraits::quantity_t>(trade.quantity() - remaining_quantity);
         if (std::abs(total_pnl) > constants::EPSILON) LIKELY
         {
-            callback(types::PnLResult{trade.timestamp(), symbol, AccountingTraits::format_precision(total_pnl)});
+            const double realized_pnl = AccountingTraits::format_precision(total_pnl);
+            callback(types::PnLResult{trade.timestamp(), symbol, realized_pnl, trade.sequence()});
+            return MatchOutcome{closed_quantity, realized_pnl};
+        }
+        return MatchOutcome{closed_quantity, 0.0};
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline std::size_t PositionTracker<AccountingTraits, AuditSink>::lot_count(const std::string& symbol) const noexcept
+    {
+        std::size_t lots = 0;
+        if (const auto it = buy_positions_.find(symbol); it != buy_positions_.end())
+        {
+            lots += it->second.size();
+        }
+        if (const auto it = sell_positions_.find(symbol); it != sell_positions_.end())
+        {
+            lots += it->second.size();
+        }
+        return lots;
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline std::uint64_t PositionTracker<AccountingTraits, AuditSink>::open_quantity(const position_container& positions) noexcept
+    {
+        if constexpr (std::is_same_v<position_container, IndexedLotBook>)
+        {
+            return positions.total_quantity();
+        }
+        else
+        {
+            std::uint64_t quantity = 0;
+            for (const auto& position : positions)
+            {
+                quantity += position.quantity();
+            }
+            return quantity;
+        }
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline typename PositionTracker<AccountingTraits, AuditSink>::SpillState::Residency&
+    PositionTracker<AccountingTraits, AuditSink>::page_in(const std::string& symbol)
+    {
+        auto [it, inserted] = spill_->residency.try_emplace(symbol);
+        auto& residency = it->second;
+
+        if (!inserted) LIKELY
+        {
+            spill_->recency.splice(spill_->recency.begin(), spill_->recency, residency.recency_position);
+            return residency;
+        }
+
+        spill_->recency.push_front(symbol);
+        residency.recency_position = spill_->recency.begin();
+        if (spill_->store.contains(symbol)) UNLIKELY
+        {
+            residency.lots = spill_->store.load(symbol, buy_positions_[symbol], sell_positions_[symbol]);
+            spill_->resident_lots += residency.lots;
+        }
+        return residency;
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::settle_residency(
+        const std::string& symbol,
+        typename SpillState::Residency& residency)
+    {
+        const std::size_t lots = lot_count(symbol);
+        spill_->resident_lots = spill_->resident_lots - residency.lots + lots;
+        residency.lots = lots;
+
+        while (spill_->resident_lots > spill_->lot_budget && spill_->recency.back() != symbol) UNLIKELY
+        {
+            spill_coldest();
+        }
+
+        spill_->peak_resident_lots = std::max(spill_->peak_resident_lots, spill_->resident_lots);
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::spill_coldest()
+    {
+        const std::string symbol = std::move(spill_->recency.back());
+        spill_->recency.pop_back();
+
+        const auto residency = spill_->residency.find(symbol);
+        const std::size_t lots = residency->second.lots;
+        spill_->residency.erase(residency);
+
+        const auto buys = buy_positions_.find(symbol);
+        const auto sells = sell_positions_.find(symbol);
+        if (lots > 0)
+        {
+            static const position_container empty_book{};
+            spill_->store.spill(symbol,
+                                buys != buy_positions_.end() ? buys->second : empty_book,
+                                sells != sell_positions_.end() ? sells->second : empty_book);
         }
+
+        if (buys != buy_positions_.end())
+        {
+            buy_positions_.erase(buys);
+        }
+        if (sells != sell_positions_.end())
+        {
+            sell_positions_.erase(sells);
+        }
+        spill_->resident_lots -= lots;
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline PnLCalculationEngine<AccountingTraits>::PnLCalculationEngine()
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::enable_spilling(std::size_t lot_budget, std::string directory)
+    {
+        // Re-enabling replaces the store, so bring every spilled book back into memory first.
+        if (spill_ != nullptr)
+        {
+            std::vector<std::string> spilled;
+            spill_->store.for_each_spilled([&spilled](const std::string& symbol, std::uint64_t, std::uint64_t)
+            {
+                spilled.push_back(symbol);
+            });
+            for (const auto& symbol : spilled)
+            {
+                spill_->store.load(symbol, buy_positions_[symbol], sell_positions_[symbol]);
+            }
+        }
+
+        spill_ = std::make_unique<SpillState>(lot_budget, std::move(directory));
+
+        std::vector<std::string> symbols;
+        for (const auto* books : {&buy_positions_, &sell_positions_})
+        {
+            for (const auto& [symbol, positions] : *books)
+            {
+                symbols.push_back(symbol);
+            }
+        }
+        for (const auto& symbol : symbols)
+        {
+            settle_residency(symbol, page_in(symbol));
+        }
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline LotSpillStats PositionTracker<AccountingTraits, AuditSink>::spill_stats() const
+    {
+        if (spill_ == nullptr)
+        {
+            return LotSpillStats{};
+        }
+
+        LotSpillStats stats = spill_->store.stats();
+        stats.resident_lots = spill_->resident_lots;
+        stats.peak_resident_lots = spill_->peak_resident_lots;
+        return stats;
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline const SnapshotTable& PositionTracker<AccountingTraits, AuditSink>::enable_snapshots(std::size_t max_symbols)
+    {
+        // Readers may already hold the table; it is kept current by every trade, so reuse it.
+        if (snapshots_ != nullptr)
+        {
+            return *snapshots_;
+        }
+
+        snapshots_ = std::make_unique<SnapshotTable>(max_symbols);
+
+        for (const auto& [symbol, positions] : buy_positions_)
+        {
+            snapshots_->seed(symbol, open_quantity(positions), 0);
+        }
+        for (const auto& [symbol, positions] : sell_positions_)
+        {
+            snapshots_->seed(symbol, 0, open_quantity(positions));
+        }
+        if (spill_ != nullptr)
+        {
+            spill_->store.for_each_spilled([this](const std::string& symbol, std::uint64_t buys, std::uint64_t sells)
+            {
+                snapshots_->seed(symbol, buys, sells);
+            });
+        }
+        return *snapshots_;
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PositionTracker<AccountingTraits, AuditSink>::clear()
+    {
+        buy_positions_.clear();
+        sell_positions_.clear();
+        if (spill_ != nullptr)
+        {
+            spill_ = std::make_unique<SpillState>(spill_->lot_budget, spill_->store.directory());
+        }
+        if (snapshots_ != nullptr)
+        {
+            snapshots_->reset();
+        }
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline PnLCalculationEngine<AccountingTraits, AuditSink>::PnLCalculationEngine()
     {
         results_.reserve(AccountingTraits::default_reserve_size);
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline PnLCalculationEngine<AccountingTraits, AuditSink>::PnLCalculationEngine(AuditSink audit)
+        : position_tracker_(std::move(audit))
+    {
+        results_.reserve(AccountingTraits::default_reserve_size);
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PnLCalculationEngine<AccountingTraits, AuditSink>::process_trade(const types::Trade& trade)
+    {
+        position_tracker_.process_trade(trade, [this](const types::PnLResult& result)
+        {
+            results_.emplace_back(result);
+        });
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
     template <concepts::TradeContainer Container>
-    inline void PnLCalculationEngine<AccountingTraits>::process_trades(const Container& trades)
+    inline void PnLCalculationEngine<AccountingTraits, AuditSink>::process_trades(const Container& trades)
     {
         for (const auto& trade : trades)
         {
@@ -146,10 +448,10 @@ namespace pnl::engine
         }
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
     template <std::ranges::input_range R>
     requires concepts::Trade<std::ranges::range_value_t<R>>
-    inline void PnLCalculationEngine<AccountingTraits>::process_trades_range(R&& trades)
+    inline void PnLCalculationEngine<AccountingTraits, AuditSink>::process_trades_range(R&& trades)
     {
         for (auto&& trade : trades)
         {
@@ -160,40 +462,70 @@ namespace pnl::engine
         }
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline const std::vector<types::PnLResult>& PnLCalculationEngine<AccountingTraits>::get_results() const noexcept
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline const std::vector<types::PnLResult>& PnLCalculationEngine<AccountingTraits, AuditSink>::get_results() const noexcept
     {
         return results_;
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline std::vector<types::PnLResult> PnLCalculationEngine<AccountingTraits>::extract_results() noexcept
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline std::vector<types::PnLResult> PnLCalculationEngine<AccountingTraits, AuditSink>::extract_results() noexcept
     {
         return std::move(results_);
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline void PnLCalculationEngine<AccountingTraits>::clear() noexcept
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PnLCalculationEngine<AccountingTraits, AuditSink>::enable_spilling(std::size_t lot_budget, std::string directory)
+    {
+        position_tracker_.enable_spilling(lot_budget, std::move(directory));
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline LotSpillStats PnLCalculationEngine<AccountingTraits, AuditSink>::spill_stats() const
+    {
+        return position_tracker_.spill_stats();
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline const SnapshotTable& PnLCalculationEngine<AccountingTraits, AuditSink>::enable_snapshots(std::size_t max_symbols)
+    {
+        return position_tracker_.enable_snapshots(max_symbols);
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline const SnapshotTable* PnLCalculationEngine<AccountingTraits, AuditSink>::snapshots() const noexcept
+    {
+        return position_tracker_.snapshots();
+    }
+
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline void PnLCalculationEngine<AccountingTraits, AuditSink>::clear()
     {
         results_.clear();
-        position_tracker_ = position_tracker_type{};
+        position_tracker_.clear();
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline std::size_t PnLCalculationEngine<AccountingTraits>::size() const noexcept
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline std::size_t PnLCalculationEngine<AccountingTraits, AuditSink>::size() const noexcept
     {
         return results_.size();
     }
 
-    template <concepts::AccountingMethod AccountingTraits>
-    inline bool PnLCalculationEngine<AccountingTraits>::empty() const noexcept
+    template <concepts::AccountingMethod AccountingTraits, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline bool PnLCalculationEngine<AccountingTraits, AuditSink>::empty() const noexcept
     {
         return results_.empty();
     }
 
-    template <enums::AccountingType Method>
+    template <enums::AccountingType Method, enums::LotBookType Book>
     inline auto create_engine()
     {
-        return PnLCalculationEngine<traits::AccountingTraits<Method>>{};
+        return PnLCalculationEngine<traits::AccountingTraits<Method, Book>>{};
+    }
+
+    template <enums::AccountingType Method, enums::LotBookType Book, concepts::AuditSink<audit::LotMatch> AuditSink>
+    inline auto create_engine(AuditSink audit)
+    {
+        return PnLCalculationEngine<traits::AccountingTraits<Method, Book>, AuditSink>{std::move(audit)};
     }
-}
\ No newline at end of file
+}
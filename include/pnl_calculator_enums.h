@@ -11,6 +11,18 @@ namespace pnl::enums
         LIFO = 1
     };
 
+    enum class LotBookType : uint8_t
+     {
+        DEQUE = 0,
+        INDEXED = 1
+    };
+
+    enum class IoBackend : uint8_t
+     {
+        READ = 0,
+        IO_URING = 1
+    };
+
     enum class TradeSide : uint8_t
      {
         BUY = 0,
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace pnl::parser
+{
+    // Symbol allow-list and inclusive timestamp range evaluated on raw CSV bytes, so rejected
+    // lines never reach price/quantity conversion or Trade construction.
+    class TradeFilter
+    {
+    public:
+        enum class Decision : std::uint8_t
+        {
+            ACCEPT = 0,
+            REJECT,
+            DEFER   // Not decidable from raw bytes (quoted or malformed fields); check the parsed trade.
+        };
+
+    private:
+        struct SymbolHash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view symbol) const noexcept
+            {
+                return std::hash<std::string_view>{}(symbol);
+            }
+        };
+
+        std::unordered_set<std::string, SymbolHash, std::equal_to<>> symbols_;
+        types::timestamp_t from_ = 0;
+        types::timestamp_t to_ = std::numeric_limits<types::timestamp_t>::max();
+
+        [[nodiscard]] bool symbol_allowed(std::string_view symbol) const noexcept;
+        [[nodiscard]] bool in_range(types::timestamp_t timestamp) const noexcept;
+
+    public:
+        RULE_OF_FIVE_COPYABLE(TradeFilter)
+
+        TradeFilter() = default;
+
+        void allow_symbol(std::string_view symbol);
+        void set_time_range(types::timestamp_t from, types::timestamp_t to) noexcept;
+
+        [[nodiscard]] bool is_active() const noexcept;
+        [[nodiscard]] std::size_t symbol_count() const noexcept { return symbols_.size(); }
+
+        [[nodiscard]] Decision evaluate_line(std::string_view line) const noexcept;
+        [[nodiscard]] bool accepts(const types::Trade& trade) const noexcept;
+    };
+}
+
+#include "pnl_calculator_filter.hxx"
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <charconv>
+
+namespace pnl::parser
+{
+    inline bool TradeFilter::symbol_allowed(std::string_view symbol) const noexcept
+    {
+        return symbols_.empty() || symbols_.find(symbol) != symbols_.end();
+    }
+
+    inline bool TradeFilter::in_range(types::timestamp_t timestamp) const noexcept
+    {
+        return timestamp >= from_ && timestamp <= to_;
+    }
+
+    inline void TradeFilter::allow_symbol(std::string_view symbol)
+    {
+        symbols_.emplace(symbol);
+    }
+
+    inline void TradeFilter::set_time_range(types::timestamp_t from, types::timestamp_t to) noexcept
+    {
+        from_ = from;
+        to_ = to;
+    }
+
+    inline bool TradeFilter::is_active() const noexcept
+    {
+        return !symbols_.empty() || from_ != 0 || to_ != std::numeric_limits<types::timestamp_t>::max();
+    }
+
+    inline TradeFilter::Decision TradeFilter::evaluate_line(std::string_view line) const noexcept
+    {
+        const auto first_delimiter = line.find(constants::CSV_DELIMITER);
+        if (first_delimiter == std::string_view::npos) UNLIKELY
+        {
+            return Decision::DEFER;
+        }
+
+        const auto second_delimiter = line.find(constants::CSV_DELIMITER, first_delimiter + 1);
+        if (second_delimiter == std::string_view::npos) UNLIKELY
+        {
+            return Decision::DEFER;
+        }
+
+        const std::string_view prefix = line.substr(0, second_delimiter);
+        if (prefix.find('"') != std::string_view::npos) UNLIKELY
+        {
+            return Decision::DEFER;
+        }
+
+        types::timestamp_t timestamp = 0;
+        const char* begin = line.data();
+        const char* end = begin + first_delimiter;
+        const auto [ptr, ec] = std::from_chars(begin, end, timestamp);
+        if (ec != std::errc{} || ptr != end) UNLIKELY
+        {
+            return Decision::DEFER;
+        }
+
+        if (!in_range(timestamp))
+        {
+            return Decision::REJECT;
+        }
+
+        const auto symbol = line.substr(first_delimiter + 1, second_delimiter - first_delimiter - 1);
+        return symbol_allowed(symbol) ? Decision::ACCEPT : Decision::REJECT;
+    }
+
+    inline bool TradeFilter::accepts(const types::Trade& trade) const noexcept
+    {
+        return in_range(trade.timestamp()) && symbol_allowed(trade.symbol());
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <optional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace pnl::engine
+{
+    // Lot book over an append-only slot sequence with Fenwick trees of quantity and cost.
+    // Clearing a quantity from either end locates the cut lot and sums the consumed cost in
+    // O(log n) regardless of how many lots are crossed. Costs are integer price ticks
+    // (PRICE_TICKS_PER_UNIT) summed modulo 2^64, so a prefix difference is exact whenever the
+    // span's true cost fits in 63 bits. Results match the deque loop bit for bit: the exact
+    // PnL is used only when the loop's double accumulation provably rounds to the same cent;
+    // otherwise (half-cent ties, prices off the tick grid, huge spans) the consumed lots are
+    // replayed in the loop's order.
+    class IndexedLotBook
+    {
+    private:
+        using quantity_sum_t = std::uint64_t;
+        using cost_sum_t = std::uint64_t;
+
+        struct Lot
+        {
+            types::price_t price;
+            types::timestamp_t timestamp;
+            types::quantity_t quantity;
+        };
+
+        std::vector<Lot> lots_;
+        std::vector<quantity_sum_t> quantity_tree_;
+        std::vector<cost_sum_t> cost_tree_;
+        std::size_t head_ = 0;
+        std::size_t tail_ = 0;
+        // Since the book was last empty: whether every lot price lay on the tick grid, and the
+        // largest tick price, which bounds the cost of any span.
+        bool on_grid_ = true;
+        cost_sum_t max_price_ticks_ = 0;
+
+        FORCE_INLINE static cost_sum_t price_ticks(types::price_t price) noexcept;
+        FORCE_INLINE static bool is_on_grid(types::price_t price) noexcept;
+        FORCE_INLINE static cost_sum_t lot_cost(types::price_t price, quantity_sum_t quantity) noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return lots_.size(); }
+        [[nodiscard]] quantity_sum_t prefix_quantity(std::size_t count) const noexcept;
+        [[nodiscard]] cost_sum_t prefix_cost(std::size_t count) const noexcept;
+        [[nodiscard]] std::size_t find_slot(quantity_sum_t cumulative_quantity) const noexcept;
+
+        void update(std::size_t slot, std::int64_t quantity_delta, cost_sum_t cost_delta) noexcept;
+        void rebuild(std::size_t new_capacity);
+
+        [[nodiscard]] std::optional<double> exact_pnl(
+            const types::Trade& trade,
+            quantity_sum_t quantity,
+            cost_sum_t cost,
+            std::size_t lots) const noexcept;
+        [[nodiscard]] double realized_pnl(
+            const types::Trade& trade,
+            quantity_sum_t quantity,
+            cost_sum_t cost,
+            std::size_t lots,
+            bool from_front) const;
+        void reset_if_empty() noexcept;
+
+    public:
+        RULE_OF_FIVE_COPYABLE(IndexedLotBook)
+
+        IndexedLotBook() = default;
+
+        [[nodiscard]] bool empty() const noexcept { return head_ == tail_; }
+        [[nodiscard]] std::size_t size() const noexcept { return tail_ - head_; }
+        [[nodiscard]] quantity_sum_t total_quantity() const noexcept;
+
+        void emplace_back(const types::Position& position);
+
+        // Consume up to remaining_quantity from the oldest (front) or newest (back) lots and
+        // return the realized PnL against trade, mirroring the deque clearing loops.
+        double clear_front(const types::Trade& trade, types::quantity_t& remaining_quantity);
+        double clear_back(const types::Trade& trade, types::quantity_t& remaining_quantity);
+
+        [[nodiscard]] types::Position front() const noexcept;
+        [[nodiscard]] types::Position back() const noexcept;
+
+        // Visits the open lots from oldest to newest.
+        template <typename Visitor>
+        void for_each(Visitor&& visitor) const;
+
+        // Visit the lots clear_front/clear_back(quantity) would consume, in consumption order,
+        // with the quantity taken from each. O(lots visited); only used for auditing.
+        template <typename Visitor>
+        void visit_front(types::quantity_t quantity, Visitor&& visitor) const;
+        template <typename Visitor>
+        void visit_back(types::quantity_t quantity, Visitor&& visitor) const;
+    };
+}
+
+#include "pnl_calculator_lotbook.hxx"
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace pnl::engine
+{
+    inline IndexedLotBook::cost_sum_t IndexedLotBook::price_ticks(types::price_t price) noexcept
+    {
+        return static_cast<cost_sum_t>(std::llround(static_cast<double>(price) * constants::PRICE_TICKS_PER_UNIT));
+    }
+
+    // True for non-negative prices within a few ulps of a whole number of ticks; anything finer
+    // (or negative, or NaN) would make the tick sum disagree with the double arithmetic.
+    inline bool IndexedLotBook::is_on_grid(types::price_t price) noexcept
+    {
+        const double scaled = static_cast<double>(price) * constants::PRICE_TICKS_PER_UNIT;
+        if (!(scaled >= 0.0 && scaled < 0x1p62)) UNLIKELY
+        {
+            return false;
+        }
+        return std::abs(scaled - std::nearbyint(scaled)) <= scaled * 0x1p-50;
+    }
+
+    inline IndexedLotBook::cost_sum_t IndexedLotBook::lot_cost(types::price_t price, quantity_sum_t quantity) noexcept
+    {
+        return price_ticks(price) * quantity;
+    }
+
+    inline IndexedLotBook::quantity_sum_t IndexedLotBook::prefix_quantity(std::size_t count) const noexcept
+    {
+        quantity_sum_t sum = 0;
+        for (; count > 0; count &= count - 1)
+        {
+            sum += quantity_tree_[count];
+        }
+        return sum;
+    }
+
+    inline IndexedLotBook::cost_sum_t IndexedLotBook::prefix_cost(std::size_t count) const noexcept
+    {
+        cost_sum_t sum = 0;
+        for (; count > 0; count &= count - 1)
+        {
+            sum += cost_tree_[count];
+        }
+        return sum;
+    }
+
+    // Returns the slot whose lot contains the cumulative_quantity-th unit, i.e. the smallest
+    // slot k with prefix_quantity(k + 1) >= cumulative_quantity.
+    inline std::size_t IndexedLotBook::find_slot(quantity_sum_t cumulative_quantity) const noexcept
+    {
+        std::size_t position = 0;
+        for (std::size_t step = std::bit_floor(capacity()); step > 0; step >>= 1)
+        {
+            const std::size_t next = position + step;
+            if (next <= capacity() && quantity_tree_[next] < cumulative_quantity)
+            {
+                position = next;
+                cumulative_quantity -= quantity_tree_[next];
+            }
+        }
+        return position;
+    }
+
+    inline void IndexedLotBook::update(std::size_t slot, std::int64_t quantity_delta, cost_sum_t cost_delta) noexcept
+    {
+        for (std::size_t i = slot + 1; i <= capacity(); i += i & (~i + 1))
+        {
+            quantity_tree_[i] += static_cast<quantity_sum_t>(quantity_delta);
+            cost_tree_[i] += cost_delta;
+        }
+    }
+
+    inline void IndexedLotBook::rebuild(std::size_t new_capacity)
+    {
+        std::vector<Lot> lots(new_capacity, Lot{0.0, 0, 0});
+        std::copy(lots_.begin() + static_cast<std::ptrdiff_t>(head_),
+                  lots_.begin() + static_cast<std::ptrdiff_t>(tail_),
+                  lots.begin());
+
+        tail_ -= head_;
+        head_ = 0;
+        lots_ = std::move(lots);
+
+        quantity_tree_.assign(new_capacity + 1, 0);
+        cost_tree_.assign(new_capacity + 1, 0);
+
+        for (std::size_t i = 1; i <= new_capacity; ++i)
+        {
+            const Lot& lot = lots_[i - 1];
+            quantity_tree_[i] += lot.quantity;
+            cost_tree_[i] += lot_cost(lot.price, lot.quantity);
+
+            const std::size_t parent = i + (i & (~i + 1));
+            if (parent <= new_capacity)
+            {
+                quantity_tree_[parent] += quantity_tree_[i];
+                cost_tree_[parent] += cost_tree_[i];
+            }
+        }
+    }
+
+    // Returns the exact PnL of clearing quantity at cost across lots, or std::nullopt unless the
+    // deque loop (a double sum of per-lot products) provably reports the same rounded cents.
+    // Each loop step and the final scaling err by at most a few ulps of the span's magnitude
+    // (proceeds + cost), so the exact value is safe once it is farther than that bound from
+    // every half-cent tie and from the EPSILON cutoff below which no result is emitted.
+    inline std::optional<double> IndexedLotBook::exact_pnl(
+        const types::Trade& trade,
+        quantity_sum_t quantity,
+        cost_sum_t cost,
+        std::size_t lots) const noexcept
+    {
+        if (!on_grid_ || !is_on_grid(trade.price())) UNLIKELY
+        {
+            return std::nullopt;
+        }
+
+        const cost_sum_t trade_ticks = price_ticks(trade.price());
+        const cost_sum_t max_ticks = std::max(max_price_ticks_, trade_ticks);
+        if (max_ticks != 0 && quantity > static_cast<quantity_sum_t>(INT64_MAX) / max_ticks) UNLIKELY
+        {
+            return std::nullopt;
+        }
+
+        // Both sums are now below 2^63, so the modular cost is the true cost.
+        const cost_sum_t proceeds = trade_ticks * quantity;
+        const std::int64_t pnl_ticks = trade.is_buy()
+                                     ? static_cast<std::int64_t>(cost) - static_cast<std::int64_t>(proceeds)
+                                     : static_cast<std::int64_t>(proceeds) - static_cast<std::int64_t>(cost);
+
+        const double magnitude = static_cast<double>(proceeds + cost) / constants::PRICE_TICKS_PER_UNIT;
+        const double error_bound = static_cast<double>(lots + 32) * 0x1p-50 * magnitude;
+        if (pnl_ticks == 0)
+        {
+            return error_bound < constants::EPSILON ? std::optional<double>(0.0) : std::nullopt;
+        }
+
+        const double pnl = static_cast<double>(pnl_ticks) / constants::PRICE_TICKS_PER_UNIT;
+        if (std::abs(pnl) - constants::EPSILON <= error_bound) UNLIKELY
+        {
+            return std::nullopt;
+        }
+
+        constexpr std::int64_t output_unit = []
+        {
+            auto ticks = static_cast<std::int64_t>(constants::PRICE_TICKS_PER_UNIT);
+            for (int digit = 0; digit < constants::DEFAULT_DECIMAL_PRECISION; ++digit)
+            {
+                ticks /= 10;
+            }
+            return ticks;
+        }();
+        std::int64_t remainder = pnl_ticks % output_unit;
+        remainder += (remainder < 0) ? output_unit : 0;
+        const double tie_distance = static_cast<double>(std::abs(2 * remainder - output_unit))
+                                  / (2.0 * constants::PRICE_TICKS_PER_UNIT);
+        if (tie_distance <= error_bound) UNLIKELY
+        {
+            return std::nullopt;
+        }
+        return pnl;
+    }
+
+    // Must run before the cleared lots are removed: the fallback replays them with the deque
+    // loop's expression and order.
+    inline double IndexedLotBook::realized_pnl(
+        const types::Trade& trade,
+        quantity_sum_t quantity,
+        cost_sum_t cost,
+        std::size_t lots,
+        bool from_front) const
+    {
+        if (const auto pnl = exact_pnl(trade, quantity, cost, lots)) LIKELY
+        {
+            return *pnl;
+        }
+
+        double total_pnl = 0.0;
+        const auto replay = [&trade, &total_pnl](const types::Position& position, types::quantity_t matched)
+        {
+            total_pnl += trade.is_buy()
+                       ? static_cast<double>(matched) * (static_cast<double>(position.price()) - static_cast<double>(trade.price()))
+                       : static_cast<double>(matched) * (static_cast<double>(trade.price()) - static_cast<double>(position.price()));
+        };
+        if (from_front)
+        {
+            visit_front(static_cast<types::quantity_t>(quantity), replay);
+        }
+        else
+        {
+            visit_back(static_cast<types::quantity_t>(quantity), replay);
+        }
+        return total_pnl;
+    }
+
+    inline void IndexedLotBook::reset_if_empty() noexcept
+    {
+        if (head_ == tail_)
+        {
+            head_ = tail_ = 0;
+            on_grid_ = true;
+            max_price_ticks_ = 0;
+        }
+    }
+
+    inline IndexedLotBook::quantity_sum_t IndexedLotBook::total_quantity() const noexcept
+    {
+        return prefix_quantity(tail_) - prefix_quantity(head_);
+    }
+
+    inline void IndexedLotBook::emplace_back(const types::Position& position)
+    {
+        if (tail_ == capacity()) UNLIKELY
+        {
+            const std::size_t live = size();
+            const std::size_t new_capacity = (live * 2 >= capacity())
+                                           ? std::max(capacity() * 2, constants::MIN_LOT_BOOK_CAPACITY)
+                                           : capacity();
+            rebuild(new_capacity);
+        }
+
+        const Lot& previous = lots_[tail_];
+        update(tail_,
+               static_cast<std::int64_t>(position.quantity()) - static_cast<std::int64_t>(previous.quantity),
+               lot_cost(position.price(), position.quantity()) - lot_cost(previous.price, previous.quantity));
+        lots_[tail_] = Lot{position.price(), position.timestamp(), position.quantity()};
+        ++tail_;
+
+        on_grid_ = on_grid_ && is_on_grid(position.price());
+        if (on_grid_) LIKELY
+        {
+            max_price_ticks_ = std::max(max_price_ticks_, price_ticks(position.price()));
+        }
+    }
+
+    inline double IndexedLotBook::clear_front(const types::Trade& trade, types::quantity_t& remaining_quantity)
+    {
+        if (empty() || remaining_quantity == 0) UNLIKELY
+        {
+            return 0.0;
+        }
+
+        const quantity_sum_t base_quantity = prefix_quantity(head_);
+        const cost_sum_t base_cost = prefix_cost(head_);
+        const quantity_sum_t available = prefix_quantity(tail_) - base_quantity;
+
+        if (available <= remaining_quantity)
+        {
+            const cost_sum_t cost = prefix_cost(tail_) - base_cost;
+            const double pnl = realized_pnl(trade, available, cost, size(), true);
+            remaining_quantity -= static_cast<types::quantity_t>(available);
+            head_ = tail_;
+            reset_if_empty();
+            return pnl;
+        }
+
+        const std::size_t cut = find_slot(base_quantity + remaining_quantity);
+        const quantity_sum_t full_quantity = prefix_quantity(cut) - base_quantity;
+        Lot& lot = lots_[cut];
+        const auto partial = static_cast<types::quantity_t>(remaining_quantity - full_quantity);
+        const cost_sum_t cost = prefix_cost(cut) - base_cost + lot_cost(lot.price, partial);
+        const double pnl = realized_pnl(trade, remaining_quantity, cost, cut - head_ + 1, true);
+
+        update(cut, -static_cast<std::int64_t>(partial), -lot_cost(lot.price, partial));
+        lot.quantity -= partial;
+        head_ = (lot.quantity == 0) ? cut + 1 : cut;
+
+        remaining_quantity = 0;
+        return pnl;
+    }
+
+    inline double IndexedLotBook::clear_back(const types::Trade& trade, types::quantity_t& remaining_quantity)
+    {
+        if (empty() || remaining_quantity == 0) UNLIKELY
+        {
+            return 0.0;
+        }
+
+        const quantity_sum_t base_quantity = prefix_quantity(head_);
+        const quantity_sum_t top_quantity = prefix_quantity(tail_);
+        const cost_sum_t top_cost = prefix_cost(tail_);
+        const quantity_sum_t available = top_quantity - base_quantity;
+
+        if (available <= remaining_quantity)
+        {
+            const cost_sum_t cost = top_cost - prefix_cost(head_);
+            const double pnl = realized_pnl(trade, available, cost, size(), false);
+            remaining_quantity -= static_cast<types::quantity_t>(available);
+            tail_ = head_;
+            reset_if_empty();
+            return pnl;
+        }
+
+        const quantity_sum_t keep_quantity = top_quantity - remaining_quantity;
+        const std::size_t cut = find_slot(keep_quantity + 1);
+        Lot& lot = lots_[cut];
+        const auto partial = static_cast<types::quantity_t>(prefix_quantity(cut + 1) - keep_quantity);
+        const cost_sum_t cost = top_cost - prefix_cost(cut + 1) + lot_cost(lot.price, partial);
+        const double pnl = realized_pnl(trade, remaining_quantity, cost, tail_ - cut, false);
+
+        if (partial == lot.quantity)
+        {
+            tail_ = cut;
+        }
+        else
+        {
+            update(cut, -static_cast<std::int64_t>(partial), -lot_cost(lot.price, partial));
+            lot.quantity -= partial;
+            tail_ = cut + 1;
+        }
+
+        remaining_quantity = 0;
+        return pnl;
+    }
+
+    inline types::Position IndexedLotBook::front() const noexcept
+    {
+        const Lot& lot = lots_[head_];
+        return types::Position{lot.price, lot.quantity, lot.timestamp};
+    }
+
+    inline types::Position IndexedLotBook::back() const noexcept
+    {
+        const Lot& lot = lots_[tail_ - 1];
+        return types::Position{lot.price, lot.quantity, lot.timestamp};
+    }
+
+    template <typename Visitor>
+    inline void IndexedLotBook::for_each(Visitor&& visitor) const
+    {
+        for (std::size_t slot = head_; slot < tail_; ++slot)
+        {
+            const Lot& lot = lots_[slot];
+            visitor(types::Position{lot.price, lot.quantity, lot.timestamp});
+        }
+    }
+
+    template <typename Visitor>
+    inline void IndexedLotBook::visit_front(types::quantity_t quantity, Visitor&& visitor) const
+    {
+        for (std::size_t slot = head_; slot < tail_ && quantity > 0; ++slot)
+        {
+            const Lot& lot = lots_[slot];
+            const types::quantity_t matched = std::min(quantity, lot.quantity);
+            visitor(types::Position{lot.price, lot.quantity, lot.timestamp}, matched);
+            quantity -= matched;
+        }
+    }
+
+    template <typename Visitor>
+    inline void IndexedLotBook::visit_back(types::quantity_t quantity, Visitor&& visitor) const
+    {
+        for (std::size_t slot = tail_; slot > head_ && quantity > 0; --slot)
+        {
+            const Lot& lot = lots_[slot - 1];
+            const types::quantity_t matched = std::min(quantity, lot.quantity);
+            visitor(types::Position{lot.price, lot.quantity, lot.timestamp}, matched);
+            quantity -= matched;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "pnl_calculator_parser.h"
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_macros.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pnl::parser
+{
+    // Merges several individually time-ordered trade files into one timestamp-ordered stream.
+    // A min-heap holds only the current head trade of each source, so memory is O(sources)
+    // regardless of input size. Equal timestamps are released in source order, and trades from
+    // the same source keep their file order.
+    class TradeStreamMerger
+    {
+    private:
+        struct SourceHead
+        {
+            types::Trade trade;
+            std::size_t source;
+        };
+
+        struct LaterFirst
+        {
+            bool operator()(const SourceHead& lhs, const SourceHead& rhs) const noexcept
+            {
+                return lhs.trade.timestamp() != rhs.trade.timestamp()
+                       ? lhs.trade.timestamp() > rhs.trade.timestamp()
+                       : lhs.source > rhs.source;
+            }
+        };
+
+        std::vector<std::unique_ptr<TradeFileStream>> sources_;
+        std::vector<SourceHead> heap_;
+        std::string unopened_file_;
+
+        void advance(std::size_t source);
+
+    public:
+        RULE_OF_FIVE_NONMOVABLE(TradeStreamMerger)
+
+        explicit TradeStreamMerger(
+            const std::vector<std::string>& filenames,
+            enums::IoBackend backend = enums::IoBackend::IO_URING,
+            const TradeFilter* filter = nullptr,
+            bool sequenced = false);
+
+        [[nodiscard]] bool is_open() const noexcept { return unopened_file_.empty(); }
+        [[nodiscard]] const std::string& unopened_file() const noexcept { return unopened_file_; }
+        [[nodiscard]] std::size_t source_count() const noexcept { return sources_.size(); }
+        [[nodiscard]] std::size_t skipped_lines() const noexcept;
+        [[nodiscard]] std::size_t filtered_lines() const noexcept;
+
+        [[nodiscard]] bool next(types::Trade& trade);
+    };
+}
+
+#include "pnl_calculator_merge.hxx"
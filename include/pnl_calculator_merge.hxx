@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+namespace pnl::parser
+{
+    inline TradeStreamMerger::TradeStreamMerger(
+        const std::vector<std::string>& filenames,
+        enums::IoBackend backend,
+        const TradeFilter* filter,
+        bool sequenced)
+    {
+        sources_.reserve(filenames.size());
+        heap_.reserve(filenames.size());
+
+        for (const auto& filename : filenames)
+        {
+            auto& source = sources_.emplace_back(
+                std::make_unique<TradeFileStream>(filename, backend, filter, sequenced, sources_.size()));
+            if (!source->is_open()) [[unlikely]]
+            {
+                unopened_file_ = filename;
+                return;
+            }
+        }
+
+        for (std::size_t source = 0; source < sources_.size(); ++source)
+        {
+            advance(source);
+        }
+    }
+
+    inline void TradeStreamMerger::advance(std::size_t source)
+    {
+        types::Trade trade;
+        if (sources_[source]->next(trade))
+        {
+            heap_.push_back(SourceHead{std::move(trade), source});
+            std::push_heap(heap_.begin(), heap_.end(), LaterFirst{});
+        }
+    }
+
+    inline std::size_t TradeStreamMerger::skipped_lines() const noexcept
+    {
+        std::size_t skipped = 0;
+        for (const auto& source : sources_)
+        {
+            skipped += source->skipped_lines();
+        }
+        return skipped;
+    }
+
+    inline std::size_t TradeStreamMerger::filtered_lines() const noexcept
+    {
+        std::size_t filtered = 0;
+        for (const auto& source : sources_)
+        {
+            filtered += source->filtered_lines();
+        }
+        return filtered;
+    }
+
+    inline bool TradeStreamMerger::next(types::Trade& trade)
+    {
+        if (heap_.empty())
+        {
+            return false;
+        }
+
+        std::pop_heap(heap_.begin(), heap_.end(), LaterFirst{});
+        SourceHead head = std::move(heap_.back());
+        heap_.pop_back();
+
+        trade = std::move(head.trade);
+        advance(head.source);
+        return true;
+    }
+}
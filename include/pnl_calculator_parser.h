@@ -4,12 +4,15 @@
 #include "pnl_calculator_types.h"
 #include "pnl_calculator_constants.h"
 #include "pnl_calculator_macros.h"
+#include "pnl_calculator_reader.h"
+#include "pnl_calculator_filter.h"
 #include <string>
 #include <vector>
 #include <fstream>
 #include <algorithm>
 #include <variant>
 #include <optional>
+#include <string_view>
 
 // Result type for error handling (C++20 compatible alternative to C++23's std::expected)
 template <typename T, typename E>
@@ -64,7 +67,11 @@ namespace pnl::parser
         static Result<types::Trade, types::ErrorResult> parse_trade_line(const std::string& line);
 
         template <concepts::StringLike Path>
-        [[nodiscard]] static std::optional<std::vector<types::Trade>> parse_file(const Path& filename);
+        [[nodiscard]] static std::optional<std::vector<types::Trade>> parse_file(
+            const Path& filename,
+            enums::IoBackend backend = enums::IoBackend::IO_URING,
+            const TradeFilter* filter = nullptr,
+            bool sequenced = false);
 
         template <typename Stream>
         requires requires(Stream& s) 
@@ -74,6 +81,53 @@ namespace pnl::parser
         }
         [[nodiscard]] ParseResult parse(Stream& stream);
     };
+
+    // Pull-based reader that yields one trade at a time so callers can stream files
+    // without materialising them. Lines are tokenized straight out of the chunks handed over by
+    // io::ChunkedFileReader. Invalid and comment lines are skipped, matching parse_file.
+    // An optional filter (owned by the caller) rejects lines on their raw bytes before conversion.
+    // Each trade's sequence is its line number, or the leading column of a sequenced (sharded) file.
+    // Line-number sequences carry source_index above SEQUENCE_SOURCE_SHIFT so they stay unique
+    // when several files feed one run; source 0 keeps the plain line number.
+    class TradeFileStream
+    {
+    private:
+        io::ChunkedFileReader reader_;
+        std::string_view chunk_;
+        std::string line_;
+        const TradeFilter* filter_;
+        bool sequenced_;
+        types::sequence_t sequence_base_;
+        std::size_t line_number_ = 0;
+        std::size_t skipped_lines_ = 0;
+        std::size_t filtered_lines_ = 0;
+
+        [[nodiscard]] bool next_line();
+        [[nodiscard]] bool next_data_line();
+        [[nodiscard]] bool strip_sequence(types::sequence_t& sequence);
+
+    public:
+        RULE_OF_FIVE_NONMOVABLE(TradeFileStream)
+
+        template <concepts::StringLike Path>
+        explicit TradeFileStream(
+            const Path& filename,
+            enums::IoBackend backend = enums::IoBackend::IO_URING,
+            const TradeFilter* filter = nullptr,
+            bool sequenced = false,
+            std::size_t source_index = 0);
+
+        [[nodiscard]] bool is_open() const noexcept { return reader_.is_open(); }
+        [[nodiscard]] enums::IoBackend backend() const noexcept { return reader_.backend(); }
+        [[nodiscard]] std::size_t line_number() const noexcept { return line_number_; }
+        [[nodiscard]] std::size_t skipped_lines() const noexcept { return skipped_lines_; }
+        [[nodiscard]] std::size_t filtered_lines() const noexcept { return filtered_lines_; }
+
+        [[nodiscard]] bool next(types::Trade& trade);
+
+        // Yields the next non-empty, non-comment line verbatim; valid until the next call.
+        [[nodiscard]] bool next_record(std::string_view& record);
+    };
 }
 
 #include "pnl_calculator_parser.hxx"
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <sstream>
 #include <fstream>
+#include <charconv>
 
 namespace pnl::parser
 {
@@ -102,20 +103,15 @@ namespace pnl::parser
     }
 
     template <concepts::StringLike Path>
-    inline std::optional<std::vector<types::Trade>> CSVParser::parse_file(const Path& filename)
+    inline std::optional<std::vector<types::Trade>> CSVParser::parse_file(
+        const Path& filename,
+        enums::IoBackend backend,
+        const TradeFilter* filter,
+        bool sequenced)
     {
-        std::ifstream file;
+        TradeFileStream stream(filename, backend, filter, sequenced);
 
-        if constexpr (std::is_same_v<Path, std::string>)
-        {
-            file.open(filename);
-        }
-        else
-        {
-            file.open(std::string(filename));
-        }
-
-        if (!file) [[unlikely]]
+        if (!stream.is_open()) [[unlikely]]
         {
             return std::nullopt;
         }
@@ -123,27 +119,10 @@ namespace pnl::parser
         std::vector<types::Trade> trades;
         trades.reserve(constants::DEFAULT_RESERVE_SIZE);
 
-        std::string line;
-        std::size_t line_number = 0;
-
-        while (std::getline(file, line))
+        types::Trade trade;
+        while (stream.next(trade))
         {
-            ++line_number;
-
-            if (line.empty() || line[0] == '#') [[unlikely]]
-            {
-                continue;
-            }
-
-            auto result = parse_trade_line(line);
-            if (result.has_value()) [[likely]]
-            {
-                trades.emplace_back(std::move(result.value()));
-            }
-            else
-            {
-                continue;
-            }
+            trades.emplace_back(std::move(trade));
         }
 
         return trades;
@@ -199,4 +178,133 @@ namespace pnl::parser
 
         return ParseResult::success(std::move(trades));
     }
+
+    template <concepts::StringLike Path>
+    inline TradeFileStream::TradeFileStream(
+        const Path& filename,
+        enums::IoBackend backend,
+        const TradeFilter* filter,
+        bool sequenced,
+        std::size_t source_index)
+        : reader_(std::string(filename), backend),
+          filter_((filter != nullptr && filter->is_active()) ? filter : nullptr),
+          sequenced_(sequenced),
+          sequence_base_(static_cast<types::sequence_t>(source_index) << constants::SEQUENCE_SOURCE_SHIFT)
+    {}
+
+    inline bool TradeFileStream::next_line()
+    {
+        line_.clear();
+
+        for (;;)
+        {
+            if (chunk_.empty())
+            {
+                if (!reader_.next_chunk(chunk_))
+                {
+                    return !line_.empty();
+                }
+                continue;
+            }
+
+            const auto newline = chunk_.find('\n');
+            if (newline == std::string_view::npos)
+            {
+                line_.append(chunk_);
+                chunk_ = {};
+                continue;
+            }
+
+            line_.append(chunk_.substr(0, newline));
+            chunk_.remove_prefix(newline + 1);
+            return true;
+        }
+    }
+
+    inline bool TradeFileStream::next_data_line()
+    {
+        while (next_line())
+        {
+            ++line_number_;
+
+            if (!line_.empty() && line_[0] != '#') [[likely]]
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    inline bool TradeFileStream::strip_sequence(types::sequence_t& sequence)
+    {
+        const auto delimiter = line_.find(constants::CSV_DELIMITER);
+        if (delimiter == std::string::npos) [[unlikely]]
+        {
+            return false;
+        }
+
+        const char* end = line_.data() + delimiter;
+        const auto [ptr, ec] = std::from_chars(line_.data(), end, sequence);
+        if (ec != std::errc{} || ptr != end || delimiter == 0) [[unlikely]]
+        {
+            return false;
+        }
+
+        line_.erase(0, delimiter + 1);
+        return true;
+    }
+
+    inline bool TradeFileStream::next_record(std::string_view& record)
+    {
+        if (!next_data_line())
+        {
+            return false;
+        }
+
+        record = line_;
+        return true;
+    }
+
+    inline bool TradeFileStream::next(types::Trade& trade)
+    {
+        while (next_data_line())
+        {
+            types::sequence_t sequence = sequence_base_ + line_number_;
+            if (sequenced_ && !strip_sequence(sequence)) [[unlikely]]
+            {
+                ++skipped_lines_;
+                continue;
+            }
+
+            auto decision = TradeFilter::Decision::ACCEPT;
+            if (filter_ != nullptr) [[unlikely]]
+            {
+                decision = filter_->evaluate_line(line_);
+                if (decision == TradeFilter::Decision::REJECT)
+                {
+                    ++filtered_lines_;
+                    continue;
+                }
+            }
+
+            auto result = CSVParser::parse_trade_line(line_);
+            if (result.has_value()) [[likely]]
+            {
+                if (decision == TradeFilter::Decision::DEFER && !filter_->accepts(result.value())) [[unlikely]]
+                {
+                    ++filtered_lines_;
+                    continue;
+                }
+
+                trade = std::move(result.value());
+                trade.set_sequence(sequence);
+                return true;
+            }
+
+            ++skipped_lines_;
+        }
+
+        return false;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "pnl_calculator_macros.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hardware counters are compiled in on Linux unless PNL_DISABLE_PERF_COUNTERS is defined.
+#if defined(__linux__) && !defined(PNL_DISABLE_PERF_COUNTERS)
+#define PNL_PERF_COUNTERS_SUPPORTED 1
+#else
+#define PNL_PERF_COUNTERS_SUPPORTED 0
+#endif
+
+namespace pnl::perf
+{
+    enum class CounterEvent : std::uint8_t
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        L1D_READ_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES
+    };
+
+    inline constexpr std::size_t COUNTER_EVENT_COUNT = 5;
+
+    constexpr const char* counter_event_to_string(CounterEvent event) noexcept
+    {
+        switch (event)
+        {
+            case CounterEvent::CYCLES: return "cycles";
+            case CounterEvent::INSTRUCTIONS: return "instructions";
+            case CounterEvent::L1D_READ_MISSES: return "l1d_misses";
+            case CounterEvent::LLC_MISSES: return "llc_misses";
+            case CounterEvent::BRANCH_MISSES: return "branch_misses";
+            default: return "unknown";
+        }
+    }
+
+    struct CounterSample
+    {
+        std::array<std::uint64_t, COUNTER_EVENT_COUNT> values{};
+        std::array<bool, COUNTER_EVENT_COUNT> valid{};
+
+        CounterSample& operator+=(const CounterSample& other) noexcept;
+    };
+
+    // One perf_event_open group counting user-space work of the calling thread. The first event
+    // that opens leads the group and the rest join it, so all counters are scheduled together and
+    // read in a single read() over the same interval. Events the kernel or hypervisor refuses are
+    // left out; if none open, available() is false and start/stop degrade to no-ops so callers
+    // still get wall-clock timings.
+    class PerfCounterGroup
+    {
+    private:
+        std::array<int, COUNTER_EVENT_COUNT> fds_;
+        int leader_fd_ = -1;
+        int open_errno_ = 0;
+
+    public:
+        PerfCounterGroup(const PerfCounterGroup&) = delete;
+        PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+        PerfCounterGroup(PerfCounterGroup&&) = delete;
+        PerfCounterGroup& operator=(PerfCounterGroup&&) = delete;
+        ~PerfCounterGroup();
+
+        PerfCounterGroup();
+
+        [[nodiscard]] bool available() const noexcept;
+        [[nodiscard]] std::string unavailable_reason() const;
+
+        void start() noexcept;
+        [[nodiscard]] CounterSample stop() noexcept;
+    };
+
+    // Accumulates counters and wall-clock time per named stage (parse, match, output, ...).
+    class StageProfiler
+    {
+    private:
+        struct Stage
+        {
+            std::string name;
+            CounterSample counters;
+            std::chrono::nanoseconds wall_time{0};
+        };
+
+        PerfCounterGroup counters_;
+        std::vector<Stage> stages_;
+
+        Stage& stage(std::string_view name);
+
+    public:
+        RULE_OF_FIVE_NONMOVABLE(StageProfiler)
+
+        StageProfiler() = default;
+
+        template <typename Function>
+        decltype(auto) measure(std::string_view stage_name, Function&& function);
+
+        [[nodiscard]] bool counters_available() const noexcept { return counters_.available(); }
+        [[nodiscard]] std::size_t stage_count() const noexcept { return stages_.size(); }
+        [[nodiscard]] const CounterSample* counters(std::string_view stage_name) const noexcept;
+        [[nodiscard]] std::chrono::nanoseconds wall_time(std::string_view stage_name) const noexcept;
+
+        void report(std::ostream& out, std::size_t trade_count) const;
+    };
+}
+
+#include "pnl_calculator_perf.hxx"
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <type_traits>
+
+#if PNL_PERF_COUNTERS_SUPPORTED
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pnl::perf
+{
+    inline CounterSample& CounterSample::operator+=(const CounterSample& other) noexcept
+    {
+        for (std::size_t i = 0; i < COUNTER_EVENT_COUNT; ++i)
+        {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+
+#if PNL_PERF_COUNTERS_SUPPORTED
+    namespace detail
+    {
+        struct EventConfig
+        {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        inline constexpr std::array<EventConfig, COUNTER_EVENT_COUNT> EVENT_CONFIGS = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+        }};
+
+        // PERF_FORMAT_GROUP layout: one enabled/running pair for the whole group, then the member
+        // values in the order they joined.
+        struct GroupReadFormat
+        {
+            std::uint64_t count;
+            std::uint64_t time_enabled;
+            std::uint64_t time_running;
+            std::uint64_t values[COUNTER_EVENT_COUNT];
+        };
+    }
+
+    inline PerfCounterGroup::PerfCounterGroup()
+    {
+        fds_.fill(-1);
+
+        for (std::size_t i = 0; i < COUNTER_EVENT_COUNT; ++i)
+        {
+            const bool leader = leader_fd_ < 0;
+
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = detail::EVENT_CONFIGS[i].type;
+            attr.config = detail::EVENT_CONFIGS[i].config;
+            attr.disabled = leader ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, leader_fd_, 0);
+            if (fd < 0) [[unlikely]]
+            {
+                if (open_errno_ == 0)
+                {
+                    open_errno_ = errno;
+                }
+                continue;
+            }
+            fds_[i] = static_cast<int>(fd);
+            if (leader)
+            {
+                leader_fd_ = fds_[i];
+            }
+        }
+    }
+
+    inline PerfCounterGroup::~PerfCounterGroup()
+    {
+        // Members first so the leader is closed last.
+        for (auto it = fds_.rbegin(); it != fds_.rend(); ++it)
+        {
+            if (*it >= 0)
+            {
+                ::close(*it);
+            }
+        }
+    }
+
+    inline void PerfCounterGroup::start() noexcept
+    {
+        if (leader_fd_ >= 0)
+        {
+            ::ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    inline CounterSample PerfCounterGroup::stop() noexcept
+    {
+        CounterSample sample;
+        if (leader_fd_ < 0)
+        {
+            return sample;
+        }
+
+        ::ioctl(leader_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        detail::GroupReadFormat reading{};
+        const ssize_t bytes = ::read(leader_fd_, &reading, sizeof(reading));
+        if (bytes < static_cast<ssize_t>(offsetof(detail::GroupReadFormat, values))) [[unlikely]]
+        {
+            return sample;
+        }
+
+        // The whole group is multiplexed as a unit, so one scale factor applies to every member.
+        const bool scaled = reading.time_running > 0 && reading.time_running < reading.time_enabled;
+        const double scale = scaled ? static_cast<double>(reading.time_enabled) / static_cast<double>(reading.time_running) : 1.0;
+
+        std::size_t member = 0;
+        for (std::size_t i = 0; i < COUNTER_EVENT_COUNT && member < reading.count; ++i)
+        {
+            if (fds_[i] < 0)
+            {
+                continue;
+            }
+
+            const std::uint64_t value = reading.values[member++];
+            sample.values[i] = scaled ? static_cast<std::uint64_t>(static_cast<double>(value) * scale) : value;
+            sample.valid[i] = reading.time_running > 0;
+        }
+
+        return sample;
+    }
+#else
+    inline PerfCounterGroup::PerfCounterGroup()
+    {
+        fds_.fill(-1);
+    }
+
+    inline PerfCounterGroup::~PerfCounterGroup() = default;
+
+    inline void PerfCounterGroup::start() noexcept {}
+
+    inline CounterSample PerfCounterGroup::stop() noexcept
+    {
+        return CounterSample{};
+    }
+#endif
+
+    inline bool PerfCounterGroup::available() const noexcept
+    {
+        return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+    }
+
+    inline std::string PerfCounterGroup::unavailable_reason() const
+    {
+#if PNL_PERF_COUNTERS_SUPPORTED
+        return open_errno_ != 0 ? std::string("perf_event_open: ") + std::strerror(open_errno_) : std::string{};
+#else
+        return "hardware counters not compiled in";
+#endif
+    }
+
+    inline StageProfiler::Stage& StageProfiler::stage(std::string_view name)
+    {
+        const auto it = std::find_if(stages_.begin(), stages_.end(),
+                                     [name](const Stage& s) { return s.name == name; });
+        if (it != stages_.end())
+        {
+            return *it;
+        }
+        return stages_.emplace_back(Stage{std::string(name), CounterSample{}, std::chrono::nanoseconds{0}});
+    }
+
+    template <typename Function>
+    inline decltype(auto) StageProfiler::measure(std::string_view stage_name, Function&& function)
+    {
+        Stage& target = stage(stage_name);
+
+        const auto finish = [this, &target](std::chrono::steady_clock::time_point begin)
+        {
+            target.counters += counters_.stop();
+            target.wall_time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin);
+        };
+
+        const auto begin = std::chrono::steady_clock::now();
+        counters_.start();
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Function>>)
+        {
+            std::forward<Function>(function)();
+            finish(begin);
+        }
+        else
+        {
+            decltype(auto) result = std::forward<Function>(function)();
+            finish(begin);
+            return result;
+        }
+    }
+
+    inline const CounterSample* StageProfiler::counters(std::string_view stage_name) const noexcept
+    {
+        const auto it = std::find_if(stages_.begin(), stages_.end(),
+                                     [stage_name](const Stage& s) { return s.name == stage_name; });
+        return it != stages_.end() ? &it->counters : nullptr;
+    }
+
+    inline std::chrono::nanoseconds StageProfiler::wall_time(std::string_view stage_name) const noexcept
+    {
+        const auto it = std::find_if(stages_.begin(), stages_.end(),
+                                     [stage_name](const Stage& s) { return s.name == stage_name; });
+        return it != stages_.end() ? it->wall_time : std::chrono::nanoseconds{0};
+    }
+
+    inline void StageProfiler::report(std::ostream& out, std::size_t trade_count) const
+    {
+        const double divisor = static_cast<double>(std::max<std::size_t>(trade_count, 1));
+
+        out << "Performance counters per trade (" << trade_count << " trades)";
+        if (!counters_available())
+        {
+            out << " - hardware counters unavailable";
+            const auto reason = counters_.unavailable_reason();
+            if (!reason.empty())
+            {
+                out << " (" << reason << ")";
+            }
+            out << ", wall-clock only";
+        }
+        out << '\n';
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(2);
+
+        for (const auto& s : stages_)
+        {
+            out << "  " << std::left << std::setw(8) << s.name << std::right
+                << " wall_ns=" << static_cast<double>(s.wall_time.count()) / divisor;
+
+            for (std::size_t i = 0; i < COUNTER_EVENT_COUNT; ++i)
+            {
+                out << ' ' << counter_event_to_string(static_cast<CounterEvent>(i)) << '=';
+                if (s.counters.valid[i])
+                {
+                    out << static_cast<double>(s.counters.values[i]) / divisor;
+                }
+                else
+                {
+                    out << "n/a";
+                }
+            }
+            out << '\n';
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
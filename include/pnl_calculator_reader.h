@@ -0,0 +1,124 @@
+#pragma once
+
+#include "pnl_calculator_enums.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/uio.h>
+
+// io_uring is used when the kernel headers provide it, unless PNL_DISABLE_IO_URING is defined.
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && !defined(PNL_DISABLE_IO_URING)
+#define PNL_IO_URING_SUPPORTED 1
+#else
+#define PNL_IO_URING_SUPPORTED 0
+#endif
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace pnl::io
+{
+    namespace detail
+    {
+        // Minimal io_uring wrapper over the raw syscalls: one submission queue of read requests
+        // and blocking reaping of completions.
+        class IoUring
+        {
+        private:
+            int ring_fd_ = -1;
+            void* sq_ring_ = nullptr;
+            std::size_t sq_ring_size_ = 0;
+            void* cq_ring_ = nullptr;
+            std::size_t cq_ring_size_ = 0;
+            io_uring_sqe* sqes_ = nullptr;
+            std::size_t sqes_size_ = 0;
+
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_mask_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned* cq_mask_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+
+        public:
+            IoUring(const IoUring&) = delete;
+            IoUring& operator=(const IoUring&) = delete;
+            IoUring(IoUring&&) = delete;
+            IoUring& operator=(IoUring&&) = delete;
+            ~IoUring();
+
+            explicit IoUring(unsigned entries) noexcept;
+
+            [[nodiscard]] bool is_valid() const noexcept { return ring_fd_ >= 0; }
+
+            [[nodiscard]] bool submit_read(int fd, void* iov, unsigned iov_count,
+                                           std::uint64_t offset, std::uint64_t user_data) noexcept;
+            [[nodiscard]] bool wait_completion(std::uint64_t& user_data, int& result) noexcept;
+
+            void close() noexcept;
+        };
+    }
+
+    // Sequential reader that hands out a file in aligned fixed-size chunks. With io_uring, up to
+    // queue_depth reads are kept in flight and chunks are delivered in file order as they complete;
+    // otherwise (kernel support missing, seccomp, non-regular files) it falls back to read().
+    // A chunk stays valid until the next call to next_chunk. Throws std::system_error on I/O errors.
+    class ChunkedFileReader
+    {
+    private:
+        struct Buffer
+        {
+            std::byte* data = nullptr;
+            iovec iov{};
+            std::uint64_t offset = 0;
+            std::size_t requested = 0;
+            std::size_t filled = 0;
+            bool in_flight = false;
+            bool ready = false;
+        };
+
+        int fd_ = -1;
+        enums::IoBackend backend_ = enums::IoBackend::READ;
+        std::size_t chunk_size_;
+        std::uint64_t file_size_ = 0;
+        std::uint64_t next_offset_ = 0;
+        std::vector<Buffer> buffers_;
+        std::size_t deliver_index_ = 0;
+        std::size_t held_index_ = 0;
+        bool holding_ = false;
+        detail::IoUring ring_;
+
+        [[nodiscard]] static std::byte* allocate_buffer(std::size_t size);
+        bool submit(std::size_t index);
+        void reap_one();
+        void complete_short_read(Buffer& buffer);
+        void release() noexcept;
+        [[nodiscard]] bool next_chunk_read(std::string_view& chunk);
+        [[nodiscard]] bool next_chunk_uring(std::string_view& chunk);
+
+    public:
+        ChunkedFileReader(const ChunkedFileReader&) = delete;
+        ChunkedFileReader& operator=(const ChunkedFileReader&) = delete;
+        ChunkedFileReader(ChunkedFileReader&&) = delete;
+        ChunkedFileReader& operator=(ChunkedFileReader&&) = delete;
+        ~ChunkedFileReader();
+
+        explicit ChunkedFileReader(
+            const std::string& filename,
+            enums::IoBackend preferred = enums::IoBackend::IO_URING,
+            std::size_t chunk_size = constants::IO_CHUNK_SIZE,
+            std::size_t queue_depth = constants::IO_QUEUE_DEPTH);
+
+        [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+        [[nodiscard]] enums::IoBackend backend() const noexcept { return backend_; }
+
+        [[nodiscard]] bool next_chunk(std::string_view& chunk);
+    };
+}
+
+#include "pnl_calculator_reader.hxx"
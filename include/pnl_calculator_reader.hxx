@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if PNL_IO_URING_SUPPORTED
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace pnl::io
+{
+    namespace detail
+    {
+#if PNL_IO_URING_SUPPORTED
+        inline IoUring::IoUring(unsigned entries) noexcept
+        {
+            if (entries == 0)
+            {
+                return;
+            }
+
+            io_uring_params params{};
+            const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+            if (fd < 0) [[unlikely]]
+            {
+                return;
+            }
+            ring_fd_ = static_cast<int>(fd);
+
+            sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+            {
+                sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+            }
+
+            sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring_fd_, IORING_OFF_SQ_RING);
+            cq_ring_ = single_mmap
+                     ? sq_ring_
+                     : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring_fd_, IORING_OFF_CQ_RING);
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring_fd_, IORING_OFF_SQES);
+
+            if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) [[unlikely]]
+            {
+                if (sq_ring_ == MAP_FAILED) sq_ring_ = nullptr;
+                if (cq_ring_ == MAP_FAILED) cq_ring_ = nullptr;
+                sqes_ = (sqes == MAP_FAILED) ? nullptr : static_cast<io_uring_sqe*>(sqes);
+                close();
+                return;
+            }
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+            auto* sq = static_cast<std::byte*>(sq_ring_);
+            auto* cq = static_cast<std::byte*>(cq_ring_);
+            sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        inline IoUring::~IoUring()
+        {
+            close();
+        }
+
+        inline void IoUring::close() noexcept
+        {
+            if (sqes_ != nullptr)
+            {
+                ::munmap(sqes_, sqes_size_);
+            }
+            if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+            {
+                ::munmap(cq_ring_, cq_ring_size_);
+            }
+            if (sq_ring_ != nullptr)
+            {
+                ::munmap(sq_ring_, sq_ring_size_);
+            }
+            if (ring_fd_ >= 0)
+            {
+                ::close(ring_fd_);
+            }
+
+            sqes_ = nullptr;
+            cq_ring_ = sq_ring_ = nullptr;
+            ring_fd_ = -1;
+        }
+
+        inline bool IoUring::submit_read(int fd, void* iov, unsigned iov_count,
+                                         std::uint64_t offset, std::uint64_t user_data) noexcept
+        {
+            const unsigned tail = *sq_tail_;
+            const unsigned index = tail & *sq_mask_;
+
+            io_uring_sqe* sqe = &sqes_[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<std::uint64_t>(iov);
+            sqe->len = iov_count;
+            sqe->off = offset;
+            sqe->user_data = user_data;
+
+            sq_array_[index] = index;
+            std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1, std::memory_order_release);
+
+            for (;;)
+            {
+                if (::syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) >= 0) [[likely]]
+                {
+                    return true;
+                }
+                if (errno != EINTR && errno != EAGAIN)
+                {
+                    return false;
+                }
+            }
+        }
+
+        inline bool IoUring::wait_completion(std::uint64_t& user_data, int& result) noexcept
+        {
+            for (;;)
+            {
+                const unsigned head = *cq_head_;
+                if (head != std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire))
+                {
+                    const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                    user_data = cqe.user_data;
+                    result = cqe.res;
+                    std::atomic_ref<unsigned>(*cq_head_).store(head + 1, std::memory_order_release);
+                    return true;
+                }
+
+                if (::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0
+                    && errno != EINTR) [[unlikely]]
+                {
+                    return false;
+                }
+            }
+        }
+#else
+        inline IoUring::IoUring(unsigned) noexcept {}
+
+        inline IoUring::~IoUring() = default;
+
+        inline void IoUring::close() noexcept {}
+
+        inline bool IoUring::submit_read(int, void*, unsigned, std::uint64_t, std::uint64_t) noexcept
+        {
+            return false;
+        }
+
+        inline bool IoUring::wait_completion(std::uint64_t&, int&) noexcept
+        {
+            return false;
+        }
+#endif
+    }
+
+    inline std::byte* ChunkedFileReader::allocate_buffer(std::size_t size)
+    {
+        return static_cast<std::byte*>(::operator new(size, std::align_val_t{constants::IO_BUFFER_ALIGNMENT}));
+    }
+
+    inline ChunkedFileReader::ChunkedFileReader(
+        const std::string& filename,
+        enums::IoBackend preferred,
+        std::size_t chunk_size,
+        std::size_t queue_depth)
+        : chunk_size_(std::max<std::size_t>(chunk_size, 1)),
+          ring_(preferred == enums::IoBackend::IO_URING ? static_cast<unsigned>(std::max<std::size_t>(queue_depth, 1)) : 0)
+    {
+        fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) [[unlikely]]
+        {
+            ring_.close();
+            return;
+        }
+
+        struct stat info{};
+        const bool regular_file = ::fstat(fd_, &info) == 0 && S_ISREG(info.st_mode);
+
+        if (ring_.is_valid() && regular_file) [[likely]]
+        {
+            backend_ = enums::IoBackend::IO_URING;
+            file_size_ = static_cast<std::uint64_t>(info.st_size);
+            try
+            {
+                buffers_.resize(std::max<std::size_t>(queue_depth, 1));
+                for (auto& buffer : buffers_)
+                {
+                    buffer.data = allocate_buffer(chunk_size_);
+                }
+
+                for (std::size_t i = 0; i < buffers_.size() && next_offset_ < file_size_; ++i)
+                {
+                    if (!submit(i)) [[unlikely]]
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                // The destructor will not run; reads already queued still target our buffers.
+                release();
+                throw;
+            }
+
+            if (backend_ == enums::IoBackend::IO_URING) [[likely]]
+            {
+                return;
+            }
+        }
+
+        ring_.close();
+        backend_ = enums::IoBackend::READ;
+        if (buffers_.empty())
+        {
+            buffers_.resize(1);
+            buffers_[0].data = allocate_buffer(chunk_size_);
+        }
+    }
+
+    inline ChunkedFileReader::~ChunkedFileReader()
+    {
+        release();
+    }
+
+    inline void ChunkedFileReader::release() noexcept
+    {
+        if (backend_ == enums::IoBackend::IO_URING)
+        {
+            // The kernel may still be writing into in-flight buffers; drain before freeing them.
+            std::uint64_t user_data = 0;
+            int result = 0;
+            while (std::any_of(buffers_.begin(), buffers_.end(), [](const Buffer& b) { return b.in_flight; })
+                   && ring_.wait_completion(user_data, result))
+            {
+                if (user_data < buffers_.size())
+                {
+                    buffers_[user_data].in_flight = false;
+                }
+            }
+        }
+        ring_.close();
+
+        for (auto& buffer : buffers_)
+        {
+            ::operator delete(buffer.data, std::align_val_t{constants::IO_BUFFER_ALIGNMENT});
+        }
+        buffers_.clear();
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+        fd_ = -1;
+    }
+
+    // Issues the next sequential read into buffer `index`. If the very first submission is
+    // rejected, switches to the read() backend so the caller can carry on.
+    inline bool ChunkedFileReader::submit(std::size_t index)
+    {
+        Buffer& buffer = buffers_[index];
+        buffer.offset = next_offset_;
+        buffer.requested = static_cast<std::size_t>(std::min<std::uint64_t>(chunk_size_, file_size_ - next_offset_));
+        buffer.filled = 0;
+        buffer.ready = false;
+
+        buffer.iov.iov_base = buffer.data;
+        buffer.iov.iov_len = buffer.requested;
+
+        if (!ring_.submit_read(fd_, &buffer.iov, 1, buffer.offset, index)) [[unlikely]]
+        {
+            const bool any_in_flight = std::any_of(buffers_.begin(), buffers_.end(),
+                                                   [](const Buffer& b) { return b.in_flight || b.ready; });
+            if (!any_in_flight && next_offset_ == 0)
+            {
+                backend_ = enums::IoBackend::READ;
+                return false;
+            }
+            throw std::system_error(errno, std::generic_category(), "io_uring submission failed");
+        }
+
+        buffer.in_flight = true;
+        next_offset_ += buffer.requested;
+        return true;
+    }
+
+    inline void ChunkedFileReader::complete_short_read(Buffer& buffer)
+    {
+        while (buffer.filled < buffer.requested)
+        {
+            const ssize_t n = ::pread(fd_, buffer.data + buffer.filled, buffer.requested - buffer.filled,
+                                      static_cast<off_t>(buffer.offset + buffer.filled));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "read failed");
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            buffer.filled += static_cast<std::size_t>(n);
+        }
+    }
+
+    inline void ChunkedFileReader::reap_one()
+    {
+        std::uint64_t user_data = 0;
+        int result = 0;
+        if (!ring_.wait_completion(user_data, result)) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "io_uring wait failed");
+        }
+
+        Buffer& buffer = buffers_[user_data];
+        buffer.in_flight = false;
+
+        if (result < 0) [[unlikely]]
+        {
+            if (result != -EINTR && result != -EAGAIN)
+            {
+                throw std::system_error(-result, std::generic_category(), "io_uring read failed");
+            }
+            result = 0;
+        }
+
+        buffer.filled = static_cast<std::size_t>(result);
+        if (buffer.filled < buffer.requested) [[unlikely]]
+        {
+            complete_short_read(buffer);
+        }
+        buffer.ready = true;
+    }
+
+    inline bool ChunkedFileReader::next_chunk_uring(std::string_view& chunk)
+    {
+        if (holding_)
+        {
+            holding_ = false;
+            if (next_offset_ < file_size_)
+            {
+                submit(held_index_);
+            }
+        }
+
+        Buffer& buffer = buffers_[deliver_index_];
+        if (!buffer.in_flight && !buffer.ready)
+        {
+            return false;
+        }
+
+        while (!buffer.ready)
+        {
+            reap_one();
+        }
+
+        buffer.ready = false;
+        if (buffer.filled == 0) [[unlikely]]
+        {
+            return false;
+        }
+
+        chunk = std::string_view(reinterpret_cast<const char*>(buffer.data), buffer.filled);
+        held_index_ = deliver_index_;
+        holding_ = true;
+        deliver_index_ = (deliver_index_ + 1) % buffers_.size();
+        return true;
+    }
+
+    inline bool ChunkedFileReader::next_chunk_read(std::string_view& chunk)
+    {
+        Buffer& buffer = buffers_[0];
+
+        for (;;)
+        {
+            const ssize_t n = ::read(fd_, buffer.data, chunk_size_);
+            if (n > 0) [[likely]]
+            {
+                chunk = std::string_view(reinterpret_cast<const char*>(buffer.data), static_cast<std::size_t>(n));
+                return true;
+            }
+            if (n == 0)
+            {
+                return false;
+            }
+            if (errno != EINTR)
+            {
+                throw std::system_error(errno, std::generic_category(), "read failed");
+            }
+        }
+    }
+
+    inline bool ChunkedFileReader::next_chunk(std::string_view& chunk)
+    {
+        if (fd_ < 0) [[unlikely]]
+        {
+            return false;
+        }
+
+        return backend_ == enums::IoBackend::IO_URING ? next_chunk_uring(chunk) : next_chunk_read(chunk);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <vector>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace pnl::engine
+{
+    // Bounded min-heap that restores timestamp order for trades arriving slightly out of order.
+    // A trade is held until the newest timestamp seen is at least lateness_tolerance ahead of it,
+    // or until the heap exceeds its capacity. Trades older than the last released timestamp are
+    // dropped and counted. Ties on timestamp are released in arrival order.
+    class ReorderBuffer
+    {
+    private:
+        struct PendingTrade
+        {
+            types::Trade trade;
+            std::uint64_t arrival;
+        };
+
+        struct LaterFirst
+        {
+            bool operator()(const PendingTrade& lhs, const PendingTrade& rhs) const noexcept
+            {
+                return lhs.trade.timestamp() != rhs.trade.timestamp()
+                       ? lhs.trade.timestamp() > rhs.trade.timestamp()
+                       : lhs.arrival > rhs.arrival;
+            }
+        };
+
+        std::vector<PendingTrade> heap_;
+        types::timestamp_t lateness_tolerance_;
+        std::size_t capacity_;
+        types::timestamp_t max_seen_timestamp_ = 0;
+        types::timestamp_t last_released_timestamp_ = 0;
+        bool has_released_ = false;
+        std::uint64_t arrivals_ = 0;
+        std::size_t late_drops_ = 0;
+
+        template <typename ReleaseCallback>
+        void release_top(ReleaseCallback& release);
+
+    public:
+        RULE_OF_FIVE_MOVABLE(ReorderBuffer)
+
+        explicit ReorderBuffer(
+            types::timestamp_t lateness_tolerance,
+            std::size_t capacity = constants::DEFAULT_REORDER_CAPACITY);
+
+        // Returns false if the trade arrived too late and was dropped.
+        template <typename ReleaseCallback>
+        requires std::invocable<ReleaseCallback, const types::Trade&>
+        bool push(types::Trade trade, ReleaseCallback&& release);
+
+        template <typename ReleaseCallback>
+        requires std::invocable<ReleaseCallback, const types::Trade&>
+        void flush(ReleaseCallback&& release);
+
+        [[nodiscard]] std::size_t pending() const noexcept { return heap_.size(); }
+        [[nodiscard]] std::size_t late_drops() const noexcept { return late_drops_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]] types::timestamp_t lateness_tolerance() const noexcept { return lateness_tolerance_; }
+    };
+}
+
+#include "pnl_calculator_reorder.hxx"
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+namespace pnl::engine
+{
+    inline ReorderBuffer::ReorderBuffer(types::timestamp_t lateness_tolerance, std::size_t capacity)
+        : lateness_tolerance_(lateness_tolerance), capacity_(std::max<std::size_t>(capacity, 1))
+    {
+        heap_.reserve(std::min(capacity_, constants::DEFAULT_RESERVE_SIZE));
+    }
+
+    template <typename ReleaseCallback>
+    inline void ReorderBuffer::release_top(ReleaseCallback& release)
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), LaterFirst{});
+        last_released_timestamp_ = heap_.back().trade.timestamp();
+        has_released_ = true;
+        release(static_cast<const types::Trade&>(heap_.back().trade));
+        heap_.pop_back();
+    }
+
+    template <typename ReleaseCallback>
+    requires std::invocable<ReleaseCallback, const types::Trade&>
+    inline bool ReorderBuffer::push(types::Trade trade, ReleaseCallback&& release)
+    {
+        if (has_released_ && trade.timestamp() < last_released_timestamp_) UNLIKELY
+        {
+            ++late_drops_;
+            return false;
+        }
+
+        max_seen_timestamp_ = std::max(max_seen_timestamp_, trade.timestamp());
+        heap_.push_back(PendingTrade{std::move(trade), arrivals_++});
+        std::push_heap(heap_.begin(), heap_.end(), LaterFirst{});
+
+        while (!heap_.empty()
+               && (max_seen_timestamp_ - heap_.front().trade.timestamp() >= lateness_tolerance_
+                   || heap_.size() > capacity_))
+        {
+            release_top(release);
+        }
+
+        return true;
+    }
+
+    template <typename ReleaseCallback>
+    requires std::invocable<ReleaseCallback, const types::Trade&>
+    inline void ReorderBuffer::flush(ReleaseCallback&& release)
+    {
+        while (!heap_.empty())
+        {
+            release_top(release);
+        }
+    }
+}
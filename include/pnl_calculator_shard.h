@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pnl_calculator_parser.h"
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_enums.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pnl::io
+{
+    // FNV-1a over the symbol bytes: stable across builds and hosts, unlike std::hash.
+    [[nodiscard]] constexpr std::uint64_t symbol_shard_hash(std::string_view symbol) noexcept;
+
+    [[nodiscard]] std::size_t shard_for_symbol(std::string_view symbol, std::size_t shard_count) noexcept;
+
+    // Splits a trade file into shard_count files named <prefix><index>.csv by symbol hash, so
+    // every trade of a symbol lands in one shard in its original order. Each line is copied
+    // verbatim behind a leading sequence column holding its input line number, which is the
+    // sequence a single-file run assigns. Returns the shard paths, or std::nullopt if the
+    // input cannot be opened. Throws std::system_error if a shard file cannot be written.
+    [[nodiscard]] std::optional<std::vector<std::string>> shard_trade_file(
+        const std::string& filename,
+        std::size_t shard_count,
+        const std::string& prefix,
+        enums::IoBackend backend = enums::IoBackend::IO_URING);
+
+    // K-way merges sequenced result files (SEQUENCED_CSV_HEADER) by sequence and writes the
+    // standard CSV output with the sequence column removed. Returns false if a file cannot be
+    // read or contains a line without a valid sequence.
+    [[nodiscard]] bool merge_sequenced_results(const std::vector<std::string>& filenames, std::ostream& out);
+}
+
+#include "pnl_calculator_shard.hxx"
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+namespace pnl::io
+{
+    inline constexpr std::uint64_t symbol_shard_hash(std::string_view symbol) noexcept
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const char c : symbol)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    inline std::size_t shard_for_symbol(std::string_view symbol, std::size_t shard_count) noexcept
+    {
+        return static_cast<std::size_t>(symbol_shard_hash(symbol) % shard_count);
+    }
+
+    namespace detail
+    {
+        // Symbol field of a raw trade line. Quoted prefixes go through the full parser so the
+        // shard matches the symbol the engine will see; unparsable lines map to an empty symbol.
+        inline std::string_view record_symbol(std::string_view record, std::string& scratch)
+        {
+            const auto first = record.find(constants::CSV_DELIMITER);
+            const auto second = (first == std::string_view::npos)
+                              ? std::string_view::npos
+                              : record.find(constants::CSV_DELIMITER, first + 1);
+            if (second != std::string_view::npos && record.substr(0, second).find('"') == std::string_view::npos) [[likely]]
+            {
+                return record.substr(first + 1, second - first - 1);
+            }
+
+            auto trade = parser::CSVParser::parse_trade_line(std::string(record));
+            scratch = trade.has_value() ? trade.value().symbol() : std::string{};
+            return scratch;
+        }
+
+        inline bool parse_sequence(std::string_view line, types::sequence_t& sequence, std::string_view& rest)
+        {
+            const auto delimiter = line.find(constants::CSV_DELIMITER);
+            if (delimiter == std::string_view::npos || delimiter == 0) [[unlikely]]
+            {
+                return false;
+            }
+
+            const auto [ptr, ec] = std::from_chars(line.data(), line.data() + delimiter, sequence);
+            if (ec != std::errc{} || ptr != line.data() + delimiter) [[unlikely]]
+            {
+                return false;
+            }
+
+            rest = line.substr(delimiter + 1);
+            return true;
+        }
+    }
+
+    inline std::optional<std::vector<std::string>> shard_trade_file(
+        const std::string& filename,
+        std::size_t shard_count,
+        const std::string& prefix,
+        enums::IoBackend backend)
+    {
+        parser::TradeFileStream stream(filename, backend);
+        if (!stream.is_open() || shard_count == 0) [[unlikely]]
+        {
+            return std::nullopt;
+        }
+
+        std::vector<std::string> paths;
+        std::vector<std::ofstream> shards;
+        paths.reserve(shard_count);
+        shards.reserve(shard_count);
+        for (std::size_t shard = 0; shard < shard_count; ++shard)
+        {
+            paths.push_back(prefix + std::to_string(shard) + constants::SHARD_FILE_EXTENSION);
+            auto& output = shards.emplace_back(paths.back(), std::ios::out | std::ios::trunc);
+            if (!output) [[unlikely]]
+            {
+                throw std::system_error(errno, std::generic_category(), "Could not create " + paths.back());
+            }
+        }
+
+        std::string scratch;
+        std::string_view record;
+        while (stream.next_record(record))
+        {
+            auto& output = shards[shard_for_symbol(detail::record_symbol(record, scratch), shard_count)];
+            output << stream.line_number() << constants::CSV_DELIMITER << record << '\n';
+        }
+
+        for (std::size_t shard = 0; shard < shard_count; ++shard)
+        {
+            shards[shard].flush();
+            if (!shards[shard]) [[unlikely]]
+            {
+                throw std::system_error(errno, std::generic_category(), "Could not write " + paths[shard]);
+            }
+        }
+
+        return paths;
+    }
+
+    inline bool merge_sequenced_results(const std::vector<std::string>& filenames, std::ostream& out)
+    {
+        struct Head
+        {
+            types::sequence_t sequence;
+            std::size_t source;
+            std::string line;
+        };
+
+        const auto later_first = [](const Head& lhs, const Head& rhs)
+        {
+            return lhs.sequence != rhs.sequence ? lhs.sequence > rhs.sequence : lhs.source > rhs.source;
+        };
+
+        std::vector<std::unique_ptr<std::ifstream>> inputs;
+        std::vector<Head> heap;
+        inputs.reserve(filenames.size());
+        heap.reserve(filenames.size());
+
+        // Pushes the next result line of source onto the heap; false on a malformed line.
+        const auto advance = [&](std::size_t source)
+        {
+            std::string line;
+            while (std::getline(*inputs[source], line))
+            {
+                if (line.empty() || line == constants::SEQUENCED_CSV_HEADER)
+                {
+                    continue;
+                }
+
+                types::sequence_t sequence = 0;
+                std::string_view rest;
+                if (!detail::parse_sequence(line, sequence, rest)) [[unlikely]]
+                {
+                    return false;
+                }
+
+                heap.push_back(Head{sequence, source, std::string(rest)});
+                std::push_heap(heap.begin(), heap.end(), later_first);
+                return true;
+            }
+            return true;
+        };
+
+        for (const auto& filename : filenames)
+        {
+            inputs.push_back(std::make_unique<std::ifstream>(filename));
+            if (!*inputs.back() || !advance(inputs.size() - 1)) [[unlikely]]
+            {
+                return false;
+            }
+        }
+
+        out << constants::CSV_HEADER << '\n';
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), later_first);
+            Head head = std::move(heap.back());
+            heap.pop_back();
+
+            out << head.line << '\n';
+            if (!advance(head.source)) [[unlikely]]
+            {
+                return false;
+            }
+        }
+        out.flush();
+
+        return static_cast<bool>(out);
+    }
+}
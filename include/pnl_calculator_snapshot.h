@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace pnl::engine
+{
+    struct SymbolSnapshot
+    {
+        std::uint64_t long_quantity = 0;
+        std::uint64_t short_quantity = 0;
+        types::pnl_t realized_pnl = 0.0;
+        types::timestamp_t last_timestamp = 0;
+        std::uint64_t trade_count = 0;
+    };
+
+    // Fixed-capacity, insert-only open-addressed table of per-symbol state, written by the one
+    // thread that processes trades and read concurrently by any number of threads. Each slot is
+    // a seqlock: the writer bumps the version to odd, stores the fields and bumps it to even, and
+    // readers retry until they see the same even version on both sides of their loads. The
+    // writer never waits on readers. A slot's symbol is written once before the slot is
+    // published and never changes, so readers can compare it without synchronization.
+    class SnapshotTable
+    {
+    private:
+        struct CACHE_LINE_ALIGNED Slot
+        {
+            std::atomic<std::uint64_t> version{0};
+            std::atomic<std::uint64_t> long_quantity{0};
+            std::atomic<std::uint64_t> short_quantity{0};
+            std::atomic<types::pnl_t> realized_pnl{0.0};
+            std::atomic<types::timestamp_t> last_timestamp{0};
+            std::atomic<std::uint64_t> trade_count{0};
+            std::atomic<bool> occupied{false};
+            std::string symbol;
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        std::size_t mask_;
+        std::size_t max_symbols_;
+        std::atomic<std::size_t> size_{0};
+        std::atomic<std::uint64_t> untracked_trades_{0};
+
+        [[nodiscard]] static std::size_t slot_count(std::size_t max_symbols) noexcept;
+        [[nodiscard]] std::size_t home_slot(std::string_view symbol) const noexcept;
+        [[nodiscard]] const Slot* find(std::string_view symbol) const noexcept;
+        [[nodiscard]] Slot* claim(std::string_view symbol) noexcept;
+        [[nodiscard]] static SymbolSnapshot read_slot(const Slot& slot) noexcept;
+        static void write_slot(Slot& slot, const SymbolSnapshot& snapshot) noexcept;
+
+    public:
+        SnapshotTable(const SnapshotTable&) = delete;
+        SnapshotTable& operator=(const SnapshotTable&) = delete;
+        SnapshotTable(SnapshotTable&&) = delete;
+        SnapshotTable& operator=(SnapshotTable&&) = delete;
+        ~SnapshotTable() = default;
+
+        explicit SnapshotTable(std::size_t max_symbols = constants::DEFAULT_SNAPSHOT_CAPACITY);
+
+        // Reader side: safe from any thread, concurrently with the writer.
+        [[nodiscard]] bool read(std::string_view symbol, SymbolSnapshot& snapshot) const noexcept;
+        template <typename Visitor>
+        void for_each(Visitor&& visitor) const;
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+        [[nodiscard]] std::size_t capacity() const noexcept { return max_symbols_; }
+        [[nodiscard]] std::uint64_t untracked_trades() const noexcept
+        {
+            return untracked_trades_.load(std::memory_order_relaxed);
+        }
+
+        // Writer side: only the thread processing trades may call these.
+        void apply(
+            std::string_view symbol,
+            enums::TradeSide side,
+            types::quantity_t opened,
+            types::quantity_t closed,
+            types::pnl_t realized_pnl,
+            types::timestamp_t timestamp) noexcept;
+        // Adds already-open quantity for symbol without counting a trade; used when the table
+        // is enabled on a tracker that already holds lots.
+        void seed(std::string_view symbol, std::uint64_t long_quantity, std::uint64_t short_quantity) noexcept;
+        void reset() noexcept;
+    };
+}
+
+#include "pnl_calculator_snapshot.hxx"
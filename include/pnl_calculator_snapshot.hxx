@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace pnl::engine
+{
+    namespace detail
+    {
+        inline void cpu_relax() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+    }
+
+    inline std::size_t SnapshotTable::slot_count(std::size_t max_symbols) noexcept
+    {
+        return std::bit_ceil(std::max<std::size_t>(max_symbols * 2, constants::MIN_LOT_BOOK_CAPACITY));
+    }
+
+    inline SnapshotTable::SnapshotTable(std::size_t max_symbols)
+        : slots_(std::make_unique<Slot[]>(slot_count(max_symbols))),
+          mask_(slot_count(max_symbols) - 1),
+          max_symbols_(max_symbols)
+    {}
+
+    inline std::size_t SnapshotTable::home_slot(std::string_view symbol) const noexcept
+    {
+        return std::hash<std::string_view>{}(symbol) & mask_;
+    }
+
+    inline const SnapshotTable::Slot* SnapshotTable::find(std::string_view symbol) const noexcept
+    {
+        for (std::size_t index = home_slot(symbol);; index = (index + 1) & mask_)
+        {
+            const Slot& slot = slots_[index];
+            if (!slot.occupied.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+            if (slot.symbol == symbol)
+            {
+                return &slot;
+            }
+        }
+    }
+
+    // A reader that catches the writer mid-update backs off exponentially before retrying, so
+    // it does not keep pulling the slot's cache line away from the writer.
+    inline SymbolSnapshot SnapshotTable::read_slot(const Slot& slot) noexcept
+    {
+        for (unsigned spins = 1;; spins = std::min(spins * 2, constants::SNAPSHOT_MAX_BACKOFF_SPINS))
+        {
+            const std::uint64_t before = slot.version.load(std::memory_order_acquire);
+            if ((before & 1) == 0) LIKELY
+            {
+                SymbolSnapshot snapshot;
+                snapshot.long_quantity = slot.long_quantity.load(std::memory_order_relaxed);
+                snapshot.short_quantity = slot.short_quantity.load(std::memory_order_relaxed);
+                snapshot.realized_pnl = slot.realized_pnl.load(std::memory_order_relaxed);
+                snapshot.last_timestamp = slot.last_timestamp.load(std::memory_order_relaxed);
+                snapshot.trade_count = slot.trade_count.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.version.load(std::memory_order_relaxed) == before) LIKELY
+                {
+                    return snapshot;
+                }
+            }
+
+            for (unsigned spin = 0; spin < spins; ++spin)
+            {
+                detail::cpu_relax();
+            }
+        }
+    }
+
+    inline void SnapshotTable::write_slot(Slot& slot, const SymbolSnapshot& snapshot) noexcept
+    {
+        const std::uint64_t version = slot.version.load(std::memory_order_relaxed);
+        slot.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.long_quantity.store(snapshot.long_quantity, std::memory_order_relaxed);
+        slot.short_quantity.store(snapshot.short_quantity, std::memory_order_relaxed);
+        slot.realized_pnl.store(snapshot.realized_pnl, std::memory_order_relaxed);
+        slot.last_timestamp.store(snapshot.last_timestamp, std::memory_order_relaxed);
+        slot.trade_count.store(snapshot.trade_count, std::memory_order_relaxed);
+
+        slot.version.store(version + 2, std::memory_order_release);
+    }
+
+    inline bool SnapshotTable::read(std::string_view symbol, SymbolSnapshot& snapshot) const noexcept
+    {
+        const Slot* slot = find(symbol);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        snapshot = read_slot(*slot);
+        return true;
+    }
+
+    template <typename Visitor>
+    inline void SnapshotTable::for_each(Visitor&& visitor) const
+    {
+        for (std::size_t index = 0; index <= mask_; ++index)
+        {
+            const Slot& slot = slots_[index];
+            if (slot.occupied.load(std::memory_order_acquire))
+            {
+                visitor(std::string_view(slot.symbol), read_slot(slot));
+            }
+        }
+    }
+
+    // Writer-side lookup that publishes a new slot for an unseen symbol; nullptr once full.
+    inline SnapshotTable::Slot* SnapshotTable::claim(std::string_view symbol) noexcept
+    {
+        for (std::size_t index = home_slot(symbol);; index = (index + 1) & mask_)
+        {
+            Slot& slot = slots_[index];
+            if (!slot.occupied.load(std::memory_order_relaxed))
+            {
+                if (size_.load(std::memory_order_relaxed) == max_symbols_) UNLIKELY
+                {
+                    return nullptr;
+                }
+
+                slot.symbol.assign(symbol);
+                slot.occupied.store(true, std::memory_order_release);
+                size_.fetch_add(1, std::memory_order_release);
+                return &slot;
+            }
+            if (slot.symbol == symbol) LIKELY
+            {
+                return &slot;
+            }
+        }
+    }
+
+    inline void SnapshotTable::apply(
+        std::string_view symbol,
+        enums::TradeSide side,
+        types::quantity_t opened,
+        types::quantity_t closed,
+        types::pnl_t realized_pnl,
+        types::timestamp_t timestamp) noexcept
+    {
+        Slot* claimed = claim(symbol);
+        if (claimed == nullptr) UNLIKELY
+        {
+            untracked_trades_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Slot& slot = *claimed;
+        SymbolSnapshot snapshot;
+        snapshot.long_quantity = slot.long_quantity.load(std::memory_order_relaxed);
+        snapshot.short_quantity = slot.short_quantity.load(std::memory_order_relaxed);
+        snapshot.realized_pnl = slot.realized_pnl.load(std::memory_order_relaxed) + realized_pnl;
+        snapshot.last_timestamp = timestamp;
+        snapshot.trade_count = slot.trade_count.load(std::memory_order_relaxed) + 1;
+
+        if (side == enums::TradeSide::BUY)
+        {
+            snapshot.short_quantity -= closed;
+            snapshot.long_quantity += opened;
+        }
+        else
+        {
+            snapshot.long_quantity -= closed;
+            snapshot.short_quantity += opened;
+        }
+
+        write_slot(slot, snapshot);
+    }
+
+    inline void SnapshotTable::seed(std::string_view symbol, std::uint64_t long_quantity, std::uint64_t short_quantity) noexcept
+    {
+        Slot* slot = claim(symbol);
+        if (slot == nullptr) UNLIKELY
+        {
+            return;
+        }
+
+        SymbolSnapshot snapshot = read_slot(*slot);
+        snapshot.long_quantity += long_quantity;
+        snapshot.short_quantity += short_quantity;
+        write_slot(*slot, snapshot);
+    }
+
+    inline void SnapshotTable::reset() noexcept
+    {
+        for (std::size_t index = 0; index <= mask_; ++index)
+        {
+            Slot& slot = slots_[index];
+            if (slot.occupied.load(std::memory_order_relaxed))
+            {
+                write_slot(slot, SymbolSnapshot{});
+            }
+        }
+        untracked_trades_.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "pnl_calculator_types.h"
+#include "pnl_calculator_constants.h"
+#include "pnl_calculator_macros.h"
+#include "pnl_calculator_lotbook.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace pnl::engine
+{
+    // Compact on-disk form of an open lot: 24 bytes against the 64-byte in-memory Position.
+    struct SpilledLot
+    {
+        types::price_t price;
+        types::timestamp_t timestamp;
+        types::quantity_t quantity;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(SpilledLot) == 24);
+
+    struct LotSpillStats
+    {
+        std::uint64_t spills = 0;
+        std::uint64_t loads = 0;
+        std::uint64_t spilled_lots = 0;
+        std::uint64_t loaded_lots = 0;
+        std::uint64_t compactions = 0;
+        std::size_t spilled_symbols = 0;
+        std::size_t resident_lots = 0;
+        std::size_t peak_resident_lots = 0;
+    };
+
+    // Anonymous scratch file in directory holding the buy and sell lot books of evicted symbols,
+    // one contiguous extent per symbol. The file is created with O_TMPFILE (or mkstemp and an
+    // immediate unlink where the filesystem lacks it), so it never has a guessable name, never
+    // replaces an existing file, and its space is reclaimed when the store closes or the process
+    // dies. Loaded extents become dead space; the file is rewritten once dead space dominates.
+    // Throws std::system_error on I/O failure.
+    class LotSpillStore
+    {
+    private:
+        struct Extent
+        {
+            std::uint64_t offset;
+            std::size_t buy_count;
+            std::size_t sell_count;
+            std::uint64_t buy_quantity;
+            std::uint64_t sell_quantity;
+        };
+
+        int fd_ = -1;
+        std::string directory_;
+        std::unordered_map<std::string, Extent> extents_;
+        std::vector<SpilledLot> buffer_;
+        std::uint64_t file_end_ = 0;
+        std::uint64_t live_bytes_ = 0;
+        LotSpillStats stats_;
+
+        [[nodiscard]] static int create_unlinked(const std::string& directory);
+        static void write_fully(int fd, const void* data, std::size_t size, std::uint64_t offset);
+        static void read_fully(int fd, void* data, std::size_t size, std::uint64_t offset);
+
+        void compact();
+
+        template <typename Book>
+        void append_lots(const Book& book);
+
+        template <typename Book>
+        void restore_lots(Book& book, const SpilledLot* lots, std::size_t count);
+
+    public:
+        LotSpillStore(const LotSpillStore&) = delete;
+        LotSpillStore& operator=(const LotSpillStore&) = delete;
+        LotSpillStore(LotSpillStore&&) = delete;
+        LotSpillStore& operator=(LotSpillStore&&) = delete;
+
+        explicit LotSpillStore(std::string directory);
+        ~LotSpillStore();
+
+        [[nodiscard]] const std::string& directory() const noexcept { return directory_; }
+        [[nodiscard]] bool contains(const std::string& symbol) const noexcept { return extents_.contains(symbol); }
+        [[nodiscard]] std::size_t spilled_symbols() const noexcept { return extents_.size(); }
+        [[nodiscard]] std::uint64_t file_size() const noexcept { return file_end_; }
+        [[nodiscard]] const LotSpillStats& stats() const noexcept { return stats_; }
+
+        // Writes both books of symbol to the file; the caller then releases the in-memory books.
+        template <typename Book>
+        void spill(const std::string& symbol, const Book& buys, const Book& sells);
+
+        // Appends the spilled lots of symbol to the (empty) books and forgets the extent.
+        // Returns the number of lots restored, or 0 if symbol was not spilled.
+        template <typename Book>
+        std::size_t load(const std::string& symbol, Book& buys, Book& sells);
+
+        // Calls visitor(symbol, buy_quantity, sell_quantity) for every spilled symbol without
+        // reading the file.
+        template <typename Visitor>
+        void for_each_spilled(Visitor&& visitor) const;
+    };
+}
+
+#include "pnl_calculator_spill.hxx"
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdlib>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace pnl::engine
+{
+    inline LotSpillStore::LotSpillStore(std::string directory)
+        : fd_(create_unlinked(directory)),
+          directory_(std::move(directory))
+    {}
+
+    inline LotSpillStore::~LotSpillStore()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    inline int LotSpillStore::create_unlinked(const std::string& directory)
+    {
+#ifdef O_TMPFILE
+        // O_EXCL keeps the anonymous file from ever being linked into the directory.
+        const int fd = ::open(directory.c_str(), O_TMPFILE | O_RDWR | O_EXCL | O_CLOEXEC, 0600);
+        if (fd >= 0) [[likely]]
+        {
+            return fd;
+        }
+        if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not create spill file in " + directory);
+        }
+#endif
+        // mkstemp picks an unpredictable name and opens it with O_EXCL, so nothing planted in
+        // the directory is followed or overwritten.
+        std::string name = directory + "/" + constants::SPILL_FILE_PREFIX + ".XXXXXX";
+        const int named_fd = ::mkostemp(name.data(), O_CLOEXEC);
+        if (named_fd < 0) [[unlikely]]
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not create spill file in " + directory);
+        }
+        ::unlink(name.c_str());
+        return named_fd;
+    }
+
+    inline void LotSpillStore::write_fully(int fd, const void* data, std::size_t size, std::uint64_t offset)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            const ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+            if (written < 0) [[unlikely]]
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Could not write spill file");
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+    }
+
+    inline void LotSpillStore::read_fully(int fd, void* data, std::size_t size, std::uint64_t offset)
+    {
+        auto* bytes = static_cast<char*>(data);
+        while (size > 0)
+        {
+            const ssize_t bytes_read = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+            if (bytes_read <= 0) [[unlikely]]
+            {
+                if (bytes_read < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(bytes_read < 0 ? errno : EIO, std::generic_category(), "Could not read spill file");
+            }
+            bytes += bytes_read;
+            size -= static_cast<std::size_t>(bytes_read);
+            offset += static_cast<std::uint64_t>(bytes_read);
+        }
+    }
+
+    inline void LotSpillStore::compact()
+    {
+        const int compacted_fd = create_unlinked(directory_);
+        std::uint64_t compacted_end = 0;
+
+        try
+        {
+            for (auto& [symbol, extent] : extents_)
+            {
+                const std::size_t bytes = (extent.buy_count + extent.sell_count) * sizeof(SpilledLot);
+                buffer_.resize(extent.buy_count + extent.sell_count);
+                read_fully(fd_, buffer_.data(), bytes, extent.offset);
+                write_fully(compacted_fd, buffer_.data(), bytes, compacted_end);
+                extent.offset = compacted_end;
+                compacted_end += bytes;
+            }
+        }
+        catch (...)
+        {
+            ::close(compacted_fd);
+            throw;
+        }
+
+        ::close(fd_);
+        fd_ = compacted_fd;
+        file_end_ = compacted_end;
+        ++stats_.compactions;
+    }
+
+    template <typename Book>
+    inline void LotSpillStore::append_lots(const Book& book)
+    {
+        const auto append = [this](const types::Position& position)
+        {
+            buffer_.push_back(SpilledLot{position.price(), position.timestamp(), position.quantity(), 0});
+        };
+
+        if constexpr (std::is_same_v<Book, IndexedLotBook>)
+        {
+            book.for_each(append);
+        }
+        else
+        {
+            for (const auto& position : book)
+            {
+                append(position);
+            }
+        }
+    }
+
+    template <typename Book>
+    inline void LotSpillStore::restore_lots(Book& book, const SpilledLot* lots, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            book.emplace_back(types::Position{lots[i].price, lots[i].quantity, lots[i].timestamp});
+        }
+    }
+
+    template <typename Book>
+    inline void LotSpillStore::spill(const std::string& symbol, const Book& buys, const Book& sells)
+    {
+        if (file_end_ >= constants::SPILL_COMPACTION_MIN_BYTES && file_end_ > 2 * live_bytes_) [[unlikely]]
+        {
+            compact();
+        }
+
+        buffer_.clear();
+        append_lots(buys);
+        const std::size_t buy_count = buffer_.size();
+        append_lots(sells);
+
+        const std::size_t bytes = buffer_.size() * sizeof(SpilledLot);
+        write_fully(fd_, buffer_.data(), bytes, file_end_);
+
+        std::uint64_t buy_quantity = 0;
+        std::uint64_t sell_quantity = 0;
+        for (std::size_t i = 0; i < buffer_.size(); ++i)
+        {
+            (i < buy_count ? buy_quantity : sell_quantity) += buffer_[i].quantity;
+        }
+        extents_.insert_or_assign(symbol, Extent{file_end_, buy_count, buffer_.size() - buy_count, buy_quantity, sell_quantity});
+        file_end_ += bytes;
+        live_bytes_ += bytes;
+
+        ++stats_.spills;
+        stats_.spilled_lots += buffer_.size();
+        stats_.spilled_symbols = extents_.size();
+    }
+
+    template <typename Book>
+    inline std::size_t LotSpillStore::load(const std::string& symbol, Book& buys, Book& sells)
+    {
+        const auto it = extents_.find(symbol);
+        if (it == extents_.end())
+        {
+            return 0;
+        }
+
+        const Extent extent = it->second;
+        const std::size_t count = extent.buy_count + extent.sell_count;
+        const std::size_t bytes = count * sizeof(SpilledLot);
+        buffer_.resize(count);
+        read_fully(fd_, buffer_.data(), bytes, extent.offset);
+
+        restore_lots(buys, buffer_.data(), extent.buy_count);
+        restore_lots(sells, buffer_.data() + extent.buy_count, extent.sell_count);
+
+        extents_.erase(it);
+        live_bytes_ -= bytes;
+
+        ++stats_.loads;
+        stats_.loaded_lots += count;
+        stats_.spilled_symbols = extents_.size();
+        return count;
+    }
+
+    template <typename Visitor>
+    inline void LotSpillStore::for_each_spilled(Visitor&& visitor) const
+    {
+        for (const auto& [symbol, extent] : extents_)
+        {
+            visitor(symbol, extent.buy_quantity, extent.sell_quantity);
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "pnl_calculator_accountingtraits.h"
 #include "pnl_calculator_macros.h"
 #include "pnl_calculator_concepts.h"
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -19,6 +20,7 @@ namespace pnl::types
     using quantity_t = AccountingTraitsBase::quantity_t;
     using symbol_t = AccountingTraitsBase::symbol_t;
     using pnl_t = AccountingTraitsBase::pnl_t;
+    using sequence_t = std::uint64_t;
 
     struct Trade;
     struct Position;
@@ -31,6 +33,7 @@ namespace pnl::types
         timestamp_t timestamp_;
         symbol_t symbol_;
         price_t price_;
+        sequence_t sequence_ = 0;
         quantity_t quantity_;
         enums::TradeSide side_;
 
@@ -48,6 +51,11 @@ namespace pnl::types
         [[nodiscard]] constexpr quantity_t quantity() const noexcept { return quantity_; }
         [[nodiscard]] constexpr enums::TradeSide side() const noexcept { return side_; }
 
+        // Input position of the trade; carried onto its PnLResult so sharded runs can be merged
+        // back into single-run output order.
+        [[nodiscard]] constexpr sequence_t sequence() const noexcept { return sequence_; }
+        constexpr void set_sequence(sequence_t sequence) noexcept { sequence_ = sequence; }
+
         [[nodiscard]] constexpr bool is_buy() const noexcept;
         [[nodiscard]] constexpr bool is_sell() const noexcept;
         static Trade parse(const std::string& csv_line);
@@ -82,17 +90,19 @@ namespace pnl::types
         timestamp_t timestamp_;
         symbol_t symbol_;
         pnl_t pnl_;
+        sequence_t sequence_ = 0;
 
     public:
         RULE_OF_FIVE_COPYABLE(PnLResult)
 
         PnLResult() = default;
 
-        PnLResult(timestamp_t ts, symbol_t sym, pnl_t p);
+        PnLResult(timestamp_t ts, symbol_t sym, pnl_t p, sequence_t seq = 0);
 
         [[nodiscard]] constexpr timestamp_t timestamp() const noexcept { return timestamp_; }
         [[nodiscard]] const symbol_t& symbol() const noexcept { return symbol_; }
         [[nodiscard]] constexpr pnl_t pnl() const noexcept { return pnl_; }
+        [[nodiscard]] constexpr sequence_t sequence() const noexcept { return sequence_; }
 
         template <int Precision = constants::DEFAULT_DECIMAL_PRECISION>
         [[nodiscard]] std::string to_csv_string() const;
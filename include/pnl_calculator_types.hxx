@@ -109,8 +109,8 @@ namespace pnl::types
         }
     }
 
-    inline PnLResult::PnLResult(timestamp_t ts, symbol_t sym, pnl_t p)
-        : timestamp_(ts), symbol_(std::move(sym)), pnl_(p)
+    inline PnLResult::PnLResult(timestamp_t ts, symbol_t sym, pnl_t p, sequence_t seq)
+        : timestamp_(ts), symbol_(std::move(sym)), pnl_(p), sequence_(seq)
     {}
 
     template <int Precision>
@@ -1,27 +1,367 @@
 #include "../include/pnl_calculator_engine.h"
 #include "../include/pnl_calculator_parser.h"
+#include "../include/pnl_calculator_merge.h"
+#include "../include/pnl_calculator_shard.h"
+#include "../include/pnl_calculator_reorder.h"
+#include "../include/pnl_calculator_binary.h"
+#include "../include/pnl_calculator_perf.h"
+#include "../include/pnl_calculator_audit.h"
 #include "../include/pnl_calculator_types.h"
 #include "../include/pnl_calculator_constants.h"
 #include "../include/pnl_calculator_enums.h"
+#include <filesystem>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <optional>
+#include <charconv>
+#include <memory>
 #include <variant>
+#include <vector>
 
 namespace pnl::app
 {
+    struct RunOptions
+    {
+        std::vector<std::string> filenames;
+        std::optional<types::timestamp_t> reorder_window;
+        enums::LotBookType lot_book = enums::LotBookType::DEQUE;
+        std::optional<std::string> binary_output;
+        bool perf_counters = false;
+        enums::IoBackend io_backend = enums::IoBackend::IO_URING;
+        parser::TradeFilter filter;
+        types::timestamp_t from = 0;
+        types::timestamp_t to = std::numeric_limits<types::timestamp_t>::max();
+        std::optional<std::size_t> memory_budget;
+        std::optional<std::string> spill_dir;
+        bool sequenced = false;
+        std::optional<std::string> audit_output;
+
+        [[nodiscard]] const parser::TradeFilter* active_filter() const noexcept
+        {
+            return filter.is_active() ? &filter : nullptr;
+        }
+    };
+
     void print_usage(const char* program_name)
     {
-        std::cerr << "Usage: " << program_name << " <input_file> <accounting_method>\n"
-                  << "  input_file: Path to CSV file containing trades\n"
+        std::cerr << "Usage: " << program_name << " <input_file>... <accounting_method> [options]\n"
+                  << "       " << program_name << " " << constants::TO_CSV_MODE << " <binary_results_file>\n"
+                  << "       " << program_name << " " << constants::SHARD_MODE << " <input_file> <shard_count> <output_prefix>\n"
+                  << "       " << program_name << " " << constants::MERGE_MODE << " <sequenced_results_file>...\n"
+                  << "  input_file: Path to CSV file containing trades; several time-ordered files\n"
+                  << "      are merged on the fly by timestamp (ties go to the earlier file)\n"
                   << "  accounting_method: 'fifo' or 'lifo'\n"
+                  << "\nOptions:\n"
+                  << "  " << constants::REORDER_WINDOW_OPT << "<ticks>  Stream the input and reorder trades\n"
+                  << "      arriving up to <ticks> timestamp units late; later trades are dropped\n"
+                  << "  " << constants::LOT_BOOK_OPT << "<deque|indexed>  Lot storage; 'indexed' clears large\n"
+                  << "      orders against fragmented books in logarithmic time\n"
+                  << "  " << constants::BINARY_OUTPUT_OPT << "<path>  Write results as fixed-width binary records\n"
+                  << "      to <path> instead of CSV on stdout; convert back with '" << constants::TO_CSV_MODE << "'\n"
+                  << "  " << constants::PERF_COUNTERS_OPT << "  Report per-trade hardware counters for the parse,\n"
+                  << "      match and output stages on stderr (wall-clock only if counters are unavailable)\n"
+                  << "  " << constants::IO_BACKEND_OPT << "<uring|read>  Input reader; 'uring' (default) keeps several\n"
+                  << "      reads in flight and falls back to 'read' when io_uring is unavailable\n"
+                  << "  " << constants::SYMBOLS_OPT << "<sym,...>  Only process trades for the listed symbols\n"
+                  << "  " << constants::FROM_OPT << "<ts>, " << constants::TO_OPT << "<ts>  Only process trades with timestamps\n"
+                  << "      in the inclusive range; filtered lines are skipped before field conversion\n"
+                  << "  " << constants::MEMORY_BUDGET_OPT << "<lots>  Stream the input and keep at most <lots> open lots\n"
+                  << "      in memory, spilling the books of the least recently traded symbols to disk\n"
+                  << "  " << constants::SPILL_DIR_OPT << "<dir>  Directory for the anonymous spill file (default: the\n"
+                  << "      system temp directory); the file has no name and vanishes on exit\n"
+                  << "  " << constants::AUDIT_OPT << "<path>  Write one CSV row per opening lot consumed by each\n"
+                  << "      closing trade (lot timestamp, lot price, matched quantity) to <path>\n"
+                  << "  " << constants::SEQUENCED_OPT << "  Input carries a leading sequence column (as written by\n"
+                  << "      '" << constants::SHARD_MODE << "') and output keeps it, for recombination with '"
+                  << constants::MERGE_MODE << "'\n"
                   << "\nExample:\n"
-                  << "  " << program_name << " trades.csv fifo\n";
+                  << "  " << program_name << " trades.csv fifo\n"
+                  << "  " << program_name << " " << constants::SHARD_MODE << " trades.csv 4 shard_  (then run each\n"
+                  << "      shard_<i>.csv with " << constants::SEQUENCED_OPT << " and '" << constants::MERGE_MODE
+                  << "' the outputs)\n";
     }
 
-    template<enums::AccountingType Method>
-    int run_calculation(const std::string& filename)
+    template <typename T>
+    std::optional<T> parse_unsigned(std::string_view text)
+    {
+        T value{};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || ptr != text.data() + text.size() || text.empty()) [[unlikely]]
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    bool parse_option(std::string_view arg, RunOptions& options)
+    {
+        const std::string_view reorder_opt = constants::REORDER_WINDOW_OPT;
+        if (arg.starts_with(reorder_opt))
+        {
+            options.reorder_window = parse_unsigned<types::timestamp_t>(arg.substr(reorder_opt.size()));
+            return options.reorder_window.has_value();
+        }
+
+        const std::string_view lot_book_opt = constants::LOT_BOOK_OPT;
+        if (arg.starts_with(lot_book_opt))
+        {
+            const auto value = arg.substr(lot_book_opt.size());
+            if (value == constants::DEQUE_LOT_BOOK_ARG)
+            {
+                options.lot_book = enums::LotBookType::DEQUE;
+                return true;
+            }
+            if (value == constants::INDEXED_LOT_BOOK_ARG)
+            {
+                options.lot_book = enums::LotBookType::INDEXED;
+                return true;
+            }
+            return false;
+        }
+
+        const std::string_view binary_output_opt = constants::BINARY_OUTPUT_OPT;
+        if (arg.starts_with(binary_output_opt) && arg.size() > binary_output_opt.size())
+        {
+            options.binary_output = std::string(arg.substr(binary_output_opt.size()));
+            return true;
+        }
+
+        if (arg == constants::PERF_COUNTERS_OPT)
+        {
+            options.perf_counters = true;
+            return true;
+        }
+
+        const std::string_view audit_opt = constants::AUDIT_OPT;
+        if (arg.starts_with(audit_opt) && arg.size() > audit_opt.size())
+        {
+            options.audit_output = std::string(arg.substr(audit_opt.size()));
+            return true;
+        }
+
+        if (arg == constants::SEQUENCED_OPT)
+        {
+            options.sequenced = true;
+            return true;
+        }
+
+        const std::string_view io_backend_opt = constants::IO_BACKEND_OPT;
+        if (arg.starts_with(io_backend_opt))
+        {
+            const auto value = arg.substr(io_backend_opt.size());
+            if (value == constants::URING_IO_BACKEND_ARG)
+            {
+                options.io_backend = enums::IoBackend::IO_URING;
+                return true;
+            }
+            if (value == constants::READ_IO_BACKEND_ARG)
+            {
+                options.io_backend = enums::IoBackend::READ;
+                return true;
+            }
+            return false;
+        }
+
+        const std::string_view memory_budget_opt = constants::MEMORY_BUDGET_OPT;
+        if (arg.starts_with(memory_budget_opt))
+        {
+            options.memory_budget = parse_unsigned<std::size_t>(arg.substr(memory_budget_opt.size()));
+            return options.memory_budget.has_value() && *options.memory_budget > 0;
+        }
+
+        const std::string_view spill_dir_opt = constants::SPILL_DIR_OPT;
+        if (arg.starts_with(spill_dir_opt) && arg.size() > spill_dir_opt.size())
+        {
+            options.spill_dir = std::string(arg.substr(spill_dir_opt.size()));
+            return true;
+        }
+
+        const std::string_view symbols_opt = constants::SYMBOLS_OPT;
+        if (arg.starts_with(symbols_opt))
+        {
+            auto symbols = arg.substr(symbols_opt.size());
+            while (!symbols.empty())
+            {
+                const auto delimiter = symbols.find(constants::CSV_DELIMITER);
+                const auto symbol = symbols.substr(0, delimiter);
+                if (symbol.empty()) [[unlikely]]
+                {
+                    return false;
+                }
+                options.filter.allow_symbol(symbol);
+                symbols = delimiter == std::string_view::npos ? std::string_view{} : symbols.substr(delimiter + 1);
+            }
+            return options.filter.symbol_count() > 0;
+        }
+
+        const std::string_view from_opt = constants::FROM_OPT;
+        const std::string_view to_opt = constants::TO_OPT;
+        if (arg.starts_with(from_opt) || arg.starts_with(to_opt))
+        {
+            const bool is_from = arg.starts_with(from_opt);
+            const auto value = parse_unsigned<types::timestamp_t>(arg.substr(is_from ? from_opt.size() : to_opt.size()));
+            if (!value) [[unlikely]]
+            {
+                return false;
+            }
+            (is_from ? options.from : options.to) = *value;
+            options.filter.set_time_range(options.from, options.to);
+            return options.from <= options.to;
+        }
+        return false;
+    }
+
+    template <typename Engine>
+    void print_results(const Engine& engine, const RunOptions& options)
     {
-        auto trades_result = parser::CSVParser::parse_file(filename);
+        const auto& results = engine.get_results();
+
+        if (options.binary_output) [[unlikely]]
+        {
+            io::BinaryResultWriter writer(*options.binary_output, results.size());
+            for (const auto& result : results)
+            {
+                writer.append(result);
+            }
+            writer.finish();
+            return;
+        }
+
+        if (options.sequenced) [[unlikely]]
+        {
+            std::cout << constants::SEQUENCED_CSV_HEADER << std::endl;
+            for (const auto& result : results)
+            {
+                std::cout << result.sequence() << constants::CSV_DELIMITER << result.to_csv_string() << std::endl;
+            }
+            return;
+        }
+
+        std::cout << constants::CSV_HEADER << std::endl;
+
+        for (const auto& result : results)
+        {
+            std::cout << result.to_csv_string() << std::endl;
+        }
+    }
+
+    template <typename Function>
+    decltype(auto) run_stage(perf::StageProfiler* profiler, std::string_view stage, Function&& function)
+    {
+        if (profiler == nullptr) [[likely]]
+        {
+            return std::forward<Function>(function)();
+        }
+        return profiler->measure(stage, std::forward<Function>(function));
+    }
+
+    void report_spill_stats(const engine::LotSpillStats& stats, std::size_t lot_budget)
+    {
+        std::cerr << "Lot spill: " << stats.spills << " spills (" << stats.spilled_lots << " lots), "
+                  << stats.loads << " loads (" << stats.loaded_lots << " lots), "
+                  << stats.compactions << " compactions; peak " << stats.peak_resident_lots
+                  << " resident lots for a budget of " << lot_budget
+                  << ", " << stats.spilled_symbols << " symbols on disk at exit" << std::endl;
+    }
+
+    template<enums::AccountingType Method, enums::LotBookType Book, typename AuditSink, typename TradeSource>
+    int stream_trades(TradeSource& source, const RunOptions& options, perf::StageProfiler* profiler, AuditSink audit)
+    {
+        auto engine = engine::create_engine<Method, Book>(audit);
+        if (options.memory_budget) [[unlikely]]
+        {
+            engine.enable_spilling(*options.memory_budget, options.spill_dir.value_or(std::filesystem::temp_directory_path().string()));
+        }
+        std::optional<engine::ReorderBuffer> reorder;
+        if (options.reorder_window) [[unlikely]]
+        {
+            reorder.emplace(*options.reorder_window);
+        }
+        const auto release = [&engine](const types::Trade& trade) { engine.process_trade(trade); };
+        std::size_t trade_count = 0;
+
+        run_stage(profiler, "stream", [&]()
+        {
+            types::Trade trade;
+            while (source.next(trade))
+            {
+                ++trade_count;
+                if (reorder) [[unlikely]]
+                {
+                    reorder->push(std::move(trade), release);
+                }
+                else
+                {
+                    engine.process_trade(trade);
+                }
+            }
+            if (reorder) [[unlikely]]
+            {
+                reorder->flush(release);
+            }
+        });
+
+        if (reorder && reorder->late_drops() > 0) [[unlikely]]
+        {
+            std::cerr << "Warning: Dropped " << reorder->late_drops()
+                      << " trades arriving later than the reorder window" << std::endl;
+        }
+
+        if (options.memory_budget) [[unlikely]]
+        {
+            report_spill_stats(engine.spill_stats(), *options.memory_budget);
+        }
+
+        run_stage(profiler, "output", [&]() { print_results(engine, options); });
+
+        if (profiler != nullptr) [[unlikely]]
+        {
+            profiler->report(std::cerr, trade_count);
+        }
+        return constants::SUCCESS;
+    }
+
+    template<enums::AccountingType Method, enums::LotBookType Book, typename AuditSink>
+    int run_streaming_calculation(const RunOptions& options, perf::StageProfiler* profiler, AuditSink audit)
+    {
+        if (options.filenames.size() > 1)
+        {
+            parser::TradeStreamMerger merger(
+                options.filenames, options.io_backend, options.active_filter(), options.sequenced);
+            if (!merger.is_open()) [[unlikely]]
+            {
+                std::cerr << "Error parsing file: Could not open file: " << merger.unopened_file() << std::endl;
+                return constants::ERROR_PARSE_ERROR;
+            }
+            return stream_trades<Method, Book>(merger, options, profiler, audit);
+        }
+
+        parser::TradeFileStream stream(
+            options.filenames.front(), options.io_backend, options.active_filter(), options.sequenced);
+        if (!stream.is_open()) [[unlikely]]
+        {
+            std::cerr << "Error parsing file: Could not open file: " << options.filenames.front() << std::endl;
+            return constants::ERROR_PARSE_ERROR;
+        }
+        return stream_trades<Method, Book>(stream, options, profiler, audit);
+    }
+
+    template<enums::AccountingType Method, enums::LotBookType Book, typename AuditSink>
+    int run_calculation(const RunOptions& options, perf::StageProfiler* profiler, AuditSink audit)
+    {
+        if (options.reorder_window || options.memory_budget || options.filenames.size() > 1) [[unlikely]]
+        {
+            return run_streaming_calculation<Method, Book>(options, profiler, audit);
+        }
+
+        const auto& filename = options.filenames.front();
+        auto trades_result = run_stage(profiler, "parse", [&filename, &options]()
+        {
+            return parser::CSVParser::parse_file(
+                filename, options.io_backend, options.active_filter(), options.sequenced);
+        });
         if (!trades_result) [[unlikely]]
         {
             std::cerr << "Error parsing file: Could not open file: " << filename << std::endl;
@@ -32,35 +372,108 @@ namespace pnl::app
         if (trades.empty()) [[unlikely]]
         {
             std::cerr << "Warning: No trades found in file" << std::endl;
-            std::cout << constants::CSV_HEADER << std::endl;
+            print_results(engine::create_engine<Method, Book>(), options);
             return constants::SUCCESS;
         }
 
-        auto engine = engine::create_engine<Method>();
-        engine.process_trades(trades);
+        auto engine = engine::create_engine<Method, Book>(audit);
+        run_stage(profiler, "match", [&]() { engine.process_trades(trades); });
+        run_stage(profiler, "output", [&]() { print_results(engine, options); });
 
-        const auto& results = engine.get_results();
+        if (profiler != nullptr) [[unlikely]]
+        {
+            profiler->report(std::cerr, trades.size());
+        }
+        return constants::SUCCESS;
+    }
 
-        std::cout << constants::CSV_HEADER << std::endl;
+    template<enums::AccountingType Method, enums::LotBookType Book>
+    int run_with_audit(const RunOptions& options, perf::StageProfiler* profiler)
+    {
+        if (!options.audit_output) [[likely]]
+        {
+            return run_calculation<Method, Book>(options, profiler, audit::NullAuditSink{});
+        }
 
-        for (const auto& result : results)
+        audit::LotMatchCsvWriter writer(*options.audit_output);
+        const int status = run_calculation<Method, Book>(options, profiler, audit::CsvAuditSink{&writer});
+        writer.flush();
+        return status;
+    }
+
+    template<enums::AccountingType Method>
+    int process_with_lot_book(const RunOptions& options)
+    {
+        std::unique_ptr<perf::StageProfiler> profiler;
+        if (options.perf_counters) [[unlikely]]
         {
-            std::cout << result.to_csv_string() << std::endl;
+            profiler = std::make_unique<perf::StageProfiler>();
+        }
+
+        switch (options.lot_book)
+        {
+            case enums::LotBookType::DEQUE:
+                return run_with_audit<Method, enums::LotBookType::DEQUE>(options, profiler.get());
+            case enums::LotBookType::INDEXED:
+                return run_with_audit<Method, enums::LotBookType::INDEXED>(options, profiler.get());
+        }
+        return run_with_audit<Method, enums::LotBookType::DEQUE>(options, profiler.get());
+    }
+
+    int convert_to_csv(const std::string& filename)
+    {
+        if (!io::convert_binary_to_csv(filename, std::cout)) [[unlikely]]
+        {
+            std::cerr << "Error: Could not read binary results file: " << filename << std::endl;
+            return constants::ERROR_PARSE_ERROR;
+        }
+        return constants::SUCCESS;
+    }
+
+    int shard_input(const std::string& filename, std::string_view shard_count_arg, const std::string& prefix)
+    {
+        const auto shard_count = parse_unsigned<std::size_t>(shard_count_arg);
+        if (!shard_count || *shard_count == 0) [[unlikely]]
+        {
+            std::cerr << "Error: Invalid shard count '" << shard_count_arg << "'." << std::endl;
+            return constants::ERROR_INVALID_ARGS;
+        }
+
+        const auto paths = io::shard_trade_file(filename, *shard_count, prefix);
+        if (!paths) [[unlikely]]
+        {
+            std::cerr << "Error parsing file: Could not open file: " << filename << std::endl;
+            return constants::ERROR_PARSE_ERROR;
+        }
+
+        for (const auto& path : *paths)
+        {
+            std::cout << path << '\n';
         }
+        return constants::SUCCESS;
+    }
 
+    int merge_results(const std::vector<std::string>& filenames)
+    {
+        if (!io::merge_sequenced_results(filenames, std::cout)) [[unlikely]]
+        {
+            std::cerr << "Error: Could not merge sequenced result files; each must be readable and start every line"
+                      << " with a sequence number" << std::endl;
+            return constants::ERROR_PARSE_ERROR;
+        }
         return constants::SUCCESS;
     }
 
-    int process_with_accounting_method(const std::string& filename, enums::AccountingType method)
+    int process_with_accounting_method(const RunOptions& options, enums::AccountingType method)
     {
         switch (method)
         {
             case enums::AccountingType::FIFO:
-                return run_calculation<enums::AccountingType::FIFO>(filename);
+                return process_with_lot_book<enums::AccountingType::FIFO>(options);
             case enums::AccountingType::LIFO:
-                return run_calculation<enums::AccountingType::LIFO>(filename);
+                return process_with_lot_book<enums::AccountingType::LIFO>(options);
         }
-        return run_calculation<enums::AccountingType::FIFO>(filename);
+        return process_with_lot_book<enums::AccountingType::FIFO>(options);
     }
 }
 
@@ -68,14 +481,71 @@ int main(int argc, char* argv[])
 {
     using namespace pnl;
 
-    if (argc != 3) [[unlikely]]
+    if (argc < 3) [[unlikely]]
     {
         app::print_usage(argv[0]);
         return constants::ERROR_INVALID_ARGS;
     }
 
-    const std::string filename = argv[1];
-    const std::string accounting_method = argv[2];
+    if (std::string_view(argv[1]) == constants::TO_CSV_MODE) [[unlikely]]
+    {
+        if (argc != 3) [[unlikely]]
+        {
+            app::print_usage(argv[0]);
+            return constants::ERROR_INVALID_ARGS;
+        }
+        return app::convert_to_csv(argv[2]);
+    }
+
+    if (std::string_view(argv[1]) == constants::SHARD_MODE) [[unlikely]]
+    {
+        if (argc != 5) [[unlikely]]
+        {
+            app::print_usage(argv[0]);
+            return constants::ERROR_INVALID_ARGS;
+        }
+
+        try
+        {
+            return app::shard_input(argv[2], argv[3], argv[4]);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return constants::ERROR_PARSE_ERROR;
+        }
+    }
+
+    if (std::string_view(argv[1]) == constants::MERGE_MODE) [[unlikely]]
+    {
+        return app::merge_results(std::vector<std::string>(argv + 2, argv + argc));
+    }
+
+    app::RunOptions options;
+    std::vector<std::string> positional;
+    std::vector<std::string_view> option_args;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with("--"))
+        {
+            option_args.push_back(arg);
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.size() < 2) [[unlikely]]
+    {
+        app::print_usage(argv[0]);
+        return constants::ERROR_INVALID_ARGS;
+    }
+
+    const std::string accounting_method = positional.back();
+    positional.pop_back();
+    options.filenames = std::move(positional);
 
     if (accounting_method != constants::FIFO_ARG && accounting_method != constants::LIFO_ARG) [[unlikely]]
     {
@@ -85,11 +555,28 @@ int main(int argc, char* argv[])
         return constants::ERROR_INVALID_ACCOUNTING;
     }
 
+    for (const auto arg : option_args)
+    {
+        if (!app::parse_option(arg, options)) [[unlikely]]
+        {
+            std::cerr << "Error: Invalid option '" << arg << "'." << std::endl;
+            app::print_usage(argv[0]);
+            return constants::ERROR_INVALID_ARGS;
+        }
+    }
+
+    if (options.sequenced && options.binary_output) [[unlikely]]
+    {
+        std::cerr << "Error: " << constants::SEQUENCED_OPT << " applies to CSV output and cannot be combined with "
+                  << constants::BINARY_OUTPUT_OPT << "." << std::endl;
+        return constants::ERROR_INVALID_ARGS;
+    }
+
     const auto method = utils::string_to_accounting_type(accounting_method);
 
     try
     {
-        return app::process_with_accounting_method(filename, method);
+        return app::process_with_accounting_method(options, method);
     }
     catch (const std::exception& e)
     {
@@ -101,4 +588,4 @@ int main(int argc, char* argv[])
         std::cerr << "Unknown error occurred" << std::endl;
         return constants::ERROR_PARSE_ERROR;
     }
-}
\ No newline at end of file
+}